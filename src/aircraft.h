@@ -67,6 +67,19 @@ struct AircraftCache {
 	uint16_t cached_max_range = 0; ///< Cached maximum range.
 };
 
+/**
+ * Where an aircraft waits for blocks of an airport to be released. The aircraft
+ * is in the waiters of the airport, and keeps waiting until the airport wakes
+ * its waiters or the aircraft itself changes.
+ */
+struct AircraftBlockWait {
+	StationID airport = StationID::Invalid(); ///< Airport the aircraft waits at, or \c StationID::Invalid() when it is not waiting.
+	bool holding = false; ///< Whether the aircraft circles in the holding pattern, instead of waiting on the ground.
+	uint8_t pos = 0; ///< Position of the aircraft when it started waiting.
+	uint8_t state = 0; ///< State of the aircraft when it started waiting.
+	OrderType order_type = OT_NOTHING; ///< Type of the current order of the aircraft when it started waiting.
+};
+
 /**
  * Aircraft, helicopters, rotors and their shadows belong to this class.
  */
@@ -82,6 +95,7 @@ struct Aircraft final : public SpecializedVehicle<Aircraft, VehicleType::Aircraf
 	VehicleAirFlags flags{}; ///< Aircraft flags. @see VehicleAirFlags
 
 	AircraftCache acache{};
+	AircraftBlockWait block_wait{}; ///< Occupied airport blocks the aircraft waits for.
 
 	Aircraft(VehicleID index) : SpecializedVehicleBase(index) {}
 	/** We want to 'destruct' the right class. */
@@ -139,6 +153,7 @@ struct Aircraft final : public SpecializedVehicle<Aircraft, VehicleType::Aircraf
 void GetRotorImage(const Aircraft *v, EngineImageType image_type, VehicleSpriteSeq *result);
 
 Station *GetTargetAirportIfValid(const Aircraft *v);
+void WakeAircraftWaitingForBlocks(Station *st);
 void HandleMissingAircraftOrders(Aircraft *v);
 
 #endif /* AIRCRAFT_H */
@@ -81,6 +81,9 @@ static bool AirportSetBlocks(Aircraft *v, const AirportFTA *current_pos, const A
 static bool AirportHasBlock(Aircraft *v, const AirportFTA *current_pos, const AirportFTAClass *apc);
 static bool AirportFindFreeTerminal(Aircraft *v, const AirportFTAClass *apc);
 static bool AirportFindFreeHelipad(Aircraft *v, const AirportFTAClass *apc);
+static void AircraftWaitForBlocks(Aircraft *v);
+static void AircraftStartWaitingForBlocks(Aircraft *v, Station *st, bool holding);
+static bool IsAircraftHoldingForBlocks(const Aircraft *v);
 static void CrashAirplane(Aircraft *v);
 
 static const SpriteID _aircraft_sprite[] = {
@@ -1229,6 +1232,7 @@ static bool HandleCrashedAircraft(Aircraft *v)
 			st->airport.blocks.Reset(AirportBlock::RunwayIn);
 			st->airport.blocks.Reset(AirportBlock::RunwayInOut); // commuter airport
 			st->airport.blocks.Reset(AirportBlock::RunwayIn2);    // intercontinental
+			WakeAircraftWaitingForBlocks(st);
 		}
 
 		delete v;
@@ -1595,7 +1599,10 @@ static void AircraftEventHandler_AtTerminal(Aircraft *v, const AirportFTAClass *
 	if (v->current_order.IsType(OT_NOTHING)) return;
 
 	/* if the block of the next position is busy, stay put */
-	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) return;
+	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) {
+		AircraftWaitForBlocks(v);
+		return;
+	}
 
 	/* airport-road is free. We either have to go to another airport, or to the hangar
 	 * ---> start moving */
@@ -1669,6 +1676,12 @@ static void AircraftEventHandler_Flying(Aircraft *v, const AirportFTAClass *apc)
 {
 	Station *st = Station::Get(v->targetairport);
 
+	/* The runways were busy when the aircraft was here last, and no blocks were released since. */
+	if (IsAircraftHoldingForBlocks(v)) {
+		v->pos = apc->layout[v->pos].next_position;
+		return;
+	}
+
 	/* Runway busy, not allowed to use this airstation or closed, circle. */
 	if (CanVehicleUseStation(v, st) && (st->owner == OWNER_NONE || st->owner == v->owner) && !st->airport.blocks.Test(AirportBlock::AirportClosed)) {
 		/* {32,FLYING,AirportBlock::Nothing,37}, {32,LANDING,N,33}, {32,HELILANDING,N,41},
@@ -1700,6 +1713,7 @@ static void AircraftEventHandler_Flying(Aircraft *v, const AirportFTAClass *apc)
 		}
 	}
 	v->state = FLYING;
+	AircraftStartWaitingForBlocks(v, st, true);
 	v->pos = apc->layout[v->pos].next_position;
 }
 
@@ -1727,7 +1741,10 @@ static void AircraftEventHandler_HeliLanding(Aircraft *v, [[maybe_unused]] const
 static void AircraftEventHandler_EndLanding(Aircraft *v, const AirportFTAClass *apc)
 {
 	/* next block busy, don't do a thing, just wait */
-	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) return;
+	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) {
+		AircraftWaitForBlocks(v);
+		return;
+	}
 
 	/* if going to terminal (OT_GOTO_STATION) choose one
 	 * 1. in case all terminals are busy AirportFindFreeTerminal() returns false or
@@ -1743,7 +1760,10 @@ static void AircraftEventHandler_EndLanding(Aircraft *v, const AirportFTAClass *
 static void AircraftEventHandler_HeliEndLanding(Aircraft *v, const AirportFTAClass *apc)
 {
 	/*  next block busy, don't do a thing, just wait */
-	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) return;
+	if (AirportHasBlock(v, &apc->layout[v->pos], apc)) {
+		AircraftWaitForBlocks(v);
+		return;
+	}
 
 	/* if going to helipad (OT_GOTO_STATION) choose one. If airport doesn't have helipads, choose terminal
 	 * 1. in case all terminals/helipads are busy (AirportFindFreeHelipad() returns false) or
@@ -1791,6 +1811,90 @@ static AircraftStateHandler * const _aircraft_state_handlers[] = {
 	AircraftEventHandler_AtTerminal,     // HELIPAD3       = 21
 };
 
+/**
+ * Check whether AircraftController() would only keep the aircraft at its position,
+ * without turning or moving it.
+ * @param v The aircraft.
+ * @param st The airport the aircraft is at.
+ * @return \c true iff the aircraft is at its position.
+ */
+static bool IsAircraftAtPosition(const Aircraft *v, const Station *st)
+{
+	const AirportMovingData amd = RotateAirportMovingData(st->airport.GetFTA()->MovingData(v->pos), st->airport.rotation, st->airport.w, st->airport.h);
+
+	/* Helicopters change the speed of their rotors while raising or lowering. */
+	if (amd.flags.Any({AirportMovingDataFlag::HeliRaise, AirportMovingDataFlag::HeliLower})) return false;
+
+	int x = TileX(st->airport.tile) * TILE_SIZE;
+	int y = TileY(st->airport.tile) * TILE_SIZE;
+	uint dist = abs(x + amd.x - v->x_pos) + abs(y + amd.y - v->y_pos);
+	if (!amd.flags.Test(AirportMovingDataFlag::ExactPosition) && dist <= (amd.flags.Test(AirportMovingDataFlag::SlowTurn) ? 8U : 4U)) return true;
+	return dist == 0 && v->direction == amd.direction;
+}
+
+/**
+ * Add the aircraft to the waiters of an airport, until a block of the airport is released.
+ * @param v The aircraft that found the blocks it needs occupied.
+ * @param st The airport.
+ * @param holding Whether the aircraft circles in the holding pattern.
+ */
+static void AircraftStartWaitingForBlocks(Aircraft *v, Station *st, bool holding)
+{
+	/* An aircraft that is woken is no longer in the waiters. */
+	if (v->block_wait.airport != st->index) st->airport.block_waiters.push_back(v->index);
+	v->block_wait = {st->index, holding, v->pos, v->state, v->current_order.GetType()};
+}
+
+/**
+ * Let the aircraft on the ground wait for a block of its airport to be released.
+ * Until then, moving it to the next position would fail the same way.
+ * @param v The aircraft that could not move to the next position.
+ */
+static void AircraftWaitForBlocks(Aircraft *v)
+{
+	Station *st = Station::Get(v->targetairport);
+	if (st->airport.tile == INVALID_TILE || v->previous_pos != v->pos || !IsAircraftAtPosition(v, st)) return;
+
+	AircraftStartWaitingForBlocks(v, st, false);
+}
+
+/**
+ * Check whether the aircraft on the ground still waits for a block of its airport to be released.
+ * @param v The aircraft.
+ * @return \c true iff nothing changed since the aircraft started waiting.
+ */
+static bool IsAircraftWaitingForBlocks(const Aircraft *v)
+{
+	const AircraftBlockWait &wait = v->block_wait;
+	if (wait.airport != v->targetairport || wait.holding || wait.pos != v->pos || wait.state != v->state || wait.order_type != v->current_order.GetType()) return false;
+	return v->previous_pos == v->pos && v->cur_speed == 0 && v->subspeed == 0;
+}
+
+/**
+ * Check whether the aircraft in the holding pattern is back where it found the runways busy, and no block was released since.
+ * @param v The aircraft.
+ * @return \c true iff looking for a free runway would fail the same way.
+ */
+static bool IsAircraftHoldingForBlocks(const Aircraft *v)
+{
+	const AircraftBlockWait &wait = v->block_wait;
+	return wait.airport == v->targetairport && wait.holding && wait.pos == v->pos && wait.state == v->state;
+}
+
+/**
+ * Wake the aircraft waiting for blocks of an airport. Call this when blocks of
+ * the airport are released, or anything else changes whether aircraft may use it.
+ * @param st The station of the airport.
+ */
+void WakeAircraftWaitingForBlocks(Station *st)
+{
+	for (VehicleID id : st->airport.block_waiters) {
+		Aircraft *v = Aircraft::GetIfValid(id);
+		if (v != nullptr && v->block_wait.airport == st->index) v->block_wait.airport = StationID::Invalid();
+	}
+	st->airport.block_waiters.clear();
+}
+
 static void AirportClearBlock(const Aircraft *v, const AirportFTAClass *apc)
 {
 	/* we have left the previous block, and entered the new one. Free the previous block */
@@ -1803,11 +1907,15 @@ static void AirportClearBlock(const Aircraft *v, const AirportFTAClass *apc)
 		}
 
 		st->airport.blocks.Reset(apc->layout[v->previous_pos].blocks);
+		WakeAircraftWaitingForBlocks(st);
 	}
 }
 
 static void AirportGoToNextPosition(Aircraft *v)
 {
+	/* if the blocks the aircraft waits for are still occupied, it would wait again */
+	if (IsAircraftWaitingForBlocks(v)) return;
+
 	/* if aircraft is not in position, wait until it is */
 	if (!AircraftController(v)) return;
 
@@ -1844,6 +1952,8 @@ static bool AirportMove(Aircraft *v, const AirportFTAClass *apc)
 		if (AirportSetBlocks(v, current, apc)) {
 			v->pos = current->next_position;
 			UpdateAircraftCache(v);
+		} else {
+			AircraftWaitForBlocks(v);
 		} // move to next position
 		return false;
 	}
@@ -1855,6 +1965,8 @@ static bool AirportMove(Aircraft *v, const AirportFTAClass *apc)
 			if (AirportSetBlocks(v, current, apc)) {
 				v->pos = current->next_position;
 				UpdateAircraftCache(v);
+			} else {
+				AircraftWaitForBlocks(v);
 			} // move to next position
 			return false;
 		}
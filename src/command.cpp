@@ -22,6 +22,7 @@
 #include "company_func.h"
 #include "company_base.h"
 #include "signal_func.h"
+#include "pbs.h"
 #include "core/backup_type.hpp"
 #include "object_base.h"
 #include "autoreplace_cmd.h"
@@ -181,6 +182,10 @@ void CommandHelperBase::InternalDoAfter(CommandCost &res, DoCommandFlags flags,
 			CheckCompanyHasMoney(res); // CheckCompanyHasMoney() modifies 'res' to an error if it fails.
 		}
 	} else {
+		/* Any change to the map might change the layout of signal blocks and reservations. */
+		InvalidateSignalBlockCache();
+		InvalidateReservationIndex();
+
 		/* If top-level, subtract the money. */
 		if (res.Succeeded() && top_level && !flags.Test(DoCommandFlag::Bankrupt)) {
 			SubtractMoneyFromCompany(_current_company, res);
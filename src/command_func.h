@@ -67,6 +67,12 @@ struct RecursiveCommandCounter {
 	 * @return \c true iff at the top level.
 	 */
 	bool IsTopLevel() const { return _counter == 1; }
+
+	/**
+	 * Is any command being tested or executed?
+	 * @return \c true iff within a command.
+	 */
+	static bool IsRunning() { return _counter > 0; }
 private:
 	static int _counter; ///< Number of instances of this class.
 };
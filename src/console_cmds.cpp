@@ -45,6 +45,11 @@
 #include "3rdparty/fmt/chrono.h"
 #include "company_cmd.h"
 #include "misc_cmd.h"
+#include "cargotype.h"
+#include "linkgraph/linkgraphschedule.h"
+#include "pathfinder/water_regions.h"
+#include "pathfinder/yapf/yapf_benchmark.h"
+#include "pathfinder/yapf/yapf_ship_regions.h"
 
 #if defined(WITH_ZLIB)
 #include "network/network_content.h"
@@ -2778,6 +2783,92 @@ static bool ConFramerateWindow(std::span<std::string_view> argv)
 	return true;
 }
 
+/** Show the measurements of the most recently joined link graph jobs. @copydoc IConsoleCmdProc */
+static bool ConLinkGraphProfile(std::span<std::string_view> argv)
+{
+	if (argv.empty()) {
+		IConsolePrint(CC_HELP, "Show how long the most recently joined link graph jobs took. Usage: 'linkgraph_profile [<count>]'.");
+		IConsolePrint(CC_HELP, "  The margin is the time between a job finishing and the game joining it; if it is negative, the game had to wait for the job.");
+		return true;
+	}
+
+	size_t count = 10;
+	if (argv.size() >= 2) {
+		auto value = ParseType<size_t>(argv[1]);
+		if (!value.has_value()) return false;
+		count = *value;
+	}
+
+	const auto &profiles = LinkGraphSchedule::instance.GetProfiles();
+	if (profiles.empty()) {
+		IConsolePrint(CC_ERROR, "No link graph jobs have been joined yet.");
+		return true;
+	}
+
+	IConsolePrint(CC_INFO, "Recalculation interval: {} seconds, time per job: {} seconds.", _settings_game.linkgraph.recalc_interval, _settings_game.linkgraph.recalc_time);
+	for (auto it = profiles.end() - std::min(count, profiles.size()); it != profiles.end(); ++it) {
+		const LinkGraphJobProfile &profile = *it;
+		const CargoSpec *cs = CargoSpec::Get(profile.cargo);
+		TimerGameEconomy::YearMonthDay ymd = TimerGameEconomy::ConvertDateToYMD(profile.join_date);
+		IConsolePrint(profile.join_margin < 0 ? CC_WARNING : CC_DEFAULT, "{:04}-{:02}-{:02}: link graph {} ({}), {} nodes, {} edges{}: {:.1f} ms, margin {:.1f} ms",
+				ymd.year, ymd.month + 1, ymd.day, profile.link_graph, cs->IsValid() ? GetString(cs->name) : std::string{"?"}, profile.nodes, profile.edges,
+				profile.incremental ? ", incremental" : "", profile.run_time / 1000.0, profile.join_margin / 1000.0);
+
+		std::string handlers;
+		for (size_t i = 0; i < LinkGraphJobProfile::NUM_HANDLERS; ++i) {
+			if (!handlers.empty()) handlers += ", ";
+			fmt::format_to(std::back_inserter(handlers), "{} {:.1f} ms", LinkGraphSchedule::HANDLER_NAMES[i], profile.handler_times[i] / 1000.0);
+			if (profile.handler_iterations[i] != 0) fmt::format_to(std::back_inserter(handlers), " ({} iterations)", profile.handler_iterations[i]);
+		}
+		IConsolePrint(CC_DEFAULT, "  {}", handlers);
+	}
+	return true;
+}
+
+/** Show how often the water regions were updated. @copydoc IConsoleCmdProc */
+static bool ConWaterRegions(std::span<std::string_view> argv)
+{
+	if (argv.empty()) {
+		IConsolePrint(CC_HELP, "Show how many water regions were updated since the map was loaded. Usage: 'water_regions'.");
+		IConsolePrint(CC_HELP, "  Bulk updates happen after loading a game or invalidating many regions, tick updates handle the few regions left in between.");
+		IConsolePrint(CC_HELP, "  Lazy updates happen while a ship searches a path and finds a region that is not updated yet.");
+		IConsolePrint(CC_HELP, "  Paths between water regions are counted since the game was started.");
+		return true;
+	}
+
+	WaterRegionStatistics statistics = GetWaterRegionStatistics();
+	IConsolePrint(CC_INFO, "Water regions: {}, of which {} need to be updated.", statistics.regions, statistics.invalid_regions);
+	IConsolePrint(CC_DEFAULT, "Updated in bulk: {}, every tick: {}, lazily: {}.", statistics.bulk_updates, statistics.tick_updates, statistics.lazy_updates);
+	auto [cached_paths, searched_paths] = YapfShipGetWaterRegionPathCacheStatistics();
+	IConsolePrint(CC_DEFAULT, "Paths between water regions taken from the cache: {}, searched: {}.", cached_paths, searched_paths);
+	return true;
+}
+
+/** Benchmark the pathfinders by recording and replaying the path searches of vehicles. @copydoc IConsoleCmdProc */
+static bool ConPathfinderBenchmark(std::span<std::string_view> argv)
+{
+	if (argv.empty()) {
+		IConsolePrint(CC_HELP, "Run the game for a number of ticks and measure all path searches. Usage: 'pf_benchmark record <ticks> <file>' or 'pf_benchmark replay <file>'.");
+		IConsolePrint(CC_HELP, "  Replay after loading the same savegame to compare the searches and the chosen tracks with the recording.");
+		IConsolePrint(CC_HELP, "  Only works in an unpaused single player game, as it runs ticks that the other players would not.");
+		return true;
+	}
+
+	if (argv.size() == 4 && argv[1] == "record") {
+		auto ticks = ParseInteger<uint>(argv[2]);
+		if (!ticks.has_value() || *ticks == 0) return false;
+		YapfBenchmarkRecord(*ticks, std::string{argv[3]});
+		return true;
+	}
+
+	if (argv.size() == 3 && argv[1] == "replay") {
+		YapfBenchmarkReplay(std::string{argv[2]});
+		return true;
+	}
+
+	return false;
+}
+
 /**
  * Format a label as a string.
  * If all elements are visible ASCII (excluding space) then the label will be formatted as a string of 4 characters,
@@ -3095,6 +3186,9 @@ void IConsoleStdLibRegister()
 #endif
 	IConsole::CmdRegister("fps",                     ConFramerate);
 	IConsole::CmdRegister("fps_wnd",                 ConFramerateWindow);
+	IConsole::CmdRegister("linkgraph_profile",       ConLinkGraphProfile);
+	IConsole::CmdRegister("water_regions",           ConWaterRegions);
+	IConsole::CmdRegister("pf_benchmark",            ConPathfinderBenchmark);
 
 	/* NewGRF development stuff */
 	IConsole::CmdRegister("reload_newgrfs",          ConNewGRFReload,     ConHookNewGRFDeveloperTool);
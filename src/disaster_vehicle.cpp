@@ -268,6 +268,7 @@ static bool DisasterTick_Zeppeliner(DisasterVehicle *v)
 		if (IsValidTile(v->tile) && IsAirportTile(v->tile)) {
 			Station *st = Station::GetByTile(v->tile);
 			st->airport.blocks.Reset({AirportBlock::Zeppeliner, AirportBlock::RunwayIn});
+			WakeAircraftWaitingForBlocks(st);
 			AI::NewEvent(GetTileOwner(v->tile), new ScriptEventDisasterZeppelinerCleared(st->index));
 		}
 
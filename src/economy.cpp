@@ -19,6 +19,8 @@
 #include "ai/ai.hpp"
 #include "aircraft.h"
 #include "train.h"
+#include "pbs.h"
+#include "pathfinder/yapf/yapf_cache.h"
 #include "newgrf_engine.h"
 #include "engine_base.h"
 #include "ground_vehicle.hpp"
@@ -477,6 +479,9 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 		for (const auto tile : Map::Iterate()) {
 			ChangeTileOwner(tile, old_owner, new_owner);
 		}
+		InvalidateSignalBlockCache();
+		InvalidateReservationIndex();
+		YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
 
 		if (new_owner != INVALID_OWNER) {
 			/* Update all signals because there can be new segment that was owned by two companies
@@ -510,6 +515,8 @@ void ChangeOwnershipOfCompanyItems(Owner old_owner, Owner new_owner)
 			 * also, drawing station window would cause reading invalid company's colour */
 			st->owner = new_owner == INVALID_OWNER ? OWNER_NONE : new_owner;
 		}
+		/* Aircraft of the old owner may now use other airports, or no longer use this one. */
+		WakeAircraftWaitingForBlocks(st);
 	}
 
 	/* do the same for waypoints (we need to do this here so deleted waypoints are converted too) */
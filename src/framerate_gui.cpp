@@ -24,7 +24,9 @@
 #include "ai/ai_instance.hpp"
 #include "game/game.hpp"
 #include "game/game_instance.hpp"
+#include "settings_type.h"
 #include "timer/timer.h"
+#include "timer/timer_game_economy.h"
 #include "timer/timer_window.h"
 #include "zoom_func.h"
 
@@ -244,6 +246,7 @@ namespace {
 		PerformanceData(1),
 		PerformanceData(1),
 		PerformanceData(1),                     // PFE_AI14
+		PerformanceData(1),                     // PFE_LINKGRAPH_JOBS
 	};
 
 }
@@ -280,7 +283,7 @@ PerformanceMeasurer::~PerformanceMeasurer()
 	if (this->elem == PFE_ALLSCRIPTS) {
 		/* Hack to not record scripts total when no scripts are active */
 		bool any_active = _pf_data[PFE_GAMESCRIPT].num_valid > 0;
-		for (uint e = PFE_AI0; e < PFE_MAX; e++) any_active |= _pf_data[e].num_valid > 0;
+		for (uint e = PFE_AI0; e <= PFE_AI14; e++) any_active |= _pf_data[e].num_valid > 0;
 		if (!any_active) {
 			PerformanceMeasurer::SetInactive(PFE_ALLSCRIPTS);
 			return;
@@ -334,6 +337,19 @@ void PerformanceMeasurer::SetExpectedRate(double rate)
 }
 
 
+/**
+ * Store a measurement of something that was not measured on the main thread,
+ * as if it ended just now.
+ * @param elem The element to store the measurement for.
+ * @param duration The duration of the measurement, in microseconds.
+ */
+/* static */ void PerformanceMeasurer::AddMeasurement(PerformanceElement elem, TimingMeasurement duration)
+{
+	TimingMeasurement end = GetPerformanceTimer();
+	_pf_data[elem].Add(end - std::min(end, duration), end);
+}
+
+
 /**
  * Begin measuring one block of the accumulating value.
  * @param elem The element to be measured
@@ -396,6 +412,7 @@ static const PerformanceElement DISPLAY_ORDER_PFE[PFE_MAX] = {
 	PFE_DRAWWORLD,
 	PFE_VIDEO,
 	PFE_SOUND,
+	PFE_LINKGRAPH_JOBS,
 };
 
 static std::string_view GetAIName(int ai_index)
@@ -404,6 +421,42 @@ static std::string_view GetAIName(int ai_index)
 	return Company::Get(ai_index)->ai_info->GetName();
 }
 
+/**
+ * Check whether an element measures an AI.
+ * @param e The element.
+ * @return True iff \a e is one of the AI elements.
+ */
+static bool IsAIElement(PerformanceElement e)
+{
+	return e >= PFE_AI0 && e <= PFE_AI14;
+}
+
+/**
+ * Get the string with the name of an element that is not an AI.
+ * The strings are in the order of the elements, but the strings of the elements after the AIs follow the string of the AIs.
+ * @param e The element.
+ * @param first The string of the first element.
+ * @param ai The string of the AIs.
+ * @return The string for \a e.
+ */
+static StringID GetElementString(PerformanceElement e, StringID first, StringID ai)
+{
+	assert(!IsAIElement(e));
+	if (e < PFE_AI0) return first + e;
+	return ai + (e - PFE_AI14);
+}
+
+/**
+ * Get the name of an element, as shown in the framerate window.
+ * @param e The element.
+ * @return The name of \a e.
+ */
+static std::string GetElementName(PerformanceElement e)
+{
+	if (IsAIElement(e)) return GetString(STR_FRAMERATE_AI, e - PFE_AI0 + 1, GetAIName(e - PFE_AI0));
+	return GetString(GetElementString(e, STR_FRAMERATE_GAMELOOP, STR_FRAMERATE_AI));
+}
+
 /** @hideinitializer */
 static constexpr std::initializer_list<NWidgetPart> _framerate_window_widgets = {
 	NWidget(NWID_HORIZONTAL),
@@ -501,8 +554,10 @@ struct FramerateWindow : Window {
 
 		int new_active = 0;
 		for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
-			this->times_shortterm[e].SetTime(_pf_data[e].GetAverageDurationMilliseconds(8), MILLISECONDS_PER_TICK);
-			this->times_longterm[e].SetTime(_pf_data[e].GetAverageDurationMilliseconds(NUM_FRAMERATE_POINTS), MILLISECONDS_PER_TICK);
+			/* Link graph jobs have until they are joined, instead of a single tick. */
+			double target = (e == PFE_LINKGRAPH_JOBS) ? (double)_settings_game.linkgraph.recalc_time / EconomyTime::SECONDS_PER_DAY * Ticks::DAY_TICKS * MILLISECONDS_PER_TICK : MILLISECONDS_PER_TICK;
+			this->times_shortterm[e].SetTime(_pf_data[e].GetAverageDurationMilliseconds(8), target);
+			this->times_longterm[e].SetTime(_pf_data[e].GetAverageDurationMilliseconds(NUM_FRAMERATE_POINTS), target);
 			if (_pf_data[e].num_valid > 0) {
 				new_active++;
 			}
@@ -562,12 +617,7 @@ struct FramerateWindow : Window {
 				fill.height = resize.height = GetCharacterHeight(FontSize::Normal);
 				for (PerformanceElement e : DISPLAY_ORDER_PFE) {
 					if (_pf_data[e].num_valid == 0) continue;
-					Dimension line_size;
-					if (e < PFE_AI0) {
-						line_size = GetStringBoundingBox(STR_FRAMERATE_GAMELOOP + e);
-					} else {
-						line_size = GetStringBoundingBox(GetString(STR_FRAMERATE_AI, e - PFE_AI0 + 1, GetAIName(e - PFE_AI0)));
-					}
+					Dimension line_size = GetStringBoundingBox(GetElementName(e));
 					size.width = std::max(size.width, line_size.width);
 				}
 				break;
@@ -626,7 +676,7 @@ struct FramerateWindow : Window {
 			if (_pf_data[e].num_valid == 0) continue;
 			if (skip > 0) {
 				skip--;
-			} else if (e == PFE_GAMESCRIPT || e >= PFE_AI0) {
+			} else if (e == PFE_GAMESCRIPT || IsAIElement(e)) {
 				uint64_t value = e == PFE_GAMESCRIPT ? Game::GetInstance()->GetAllocatedMemory() : Company::Get(e - PFE_AI0)->ai_instance->GetAllocatedMemory();
 				DrawString(r.left, r.right, y, GetString(STR_FRAMERATE_BYTES_GOOD, value), TC_FROMSTRING, SA_RIGHT | SA_FORCE);
 				y += GetCharacterHeight(FontSize::Normal);
@@ -660,11 +710,7 @@ struct FramerateWindow : Window {
 					if (skip > 0) {
 						skip--;
 					} else {
-						if (e < PFE_AI0) {
-							DrawString(r.left, r.right, y, STR_FRAMERATE_GAMELOOP + e, TC_FROMSTRING, SA_LEFT);
-						} else {
-							DrawString(r.left, r.right, y, GetString(STR_FRAMERATE_AI, e - PFE_AI0 + 1, GetAIName(e - PFE_AI0)), TC_FROMSTRING, SA_LEFT);
-						}
+						DrawString(r.left, r.right, y, GetElementName(e), TC_FROMSTRING, SA_LEFT);
 						y += GetCharacterHeight(FontSize::Normal);
 						drawable--;
 						if (drawable == 0) break;
@@ -759,10 +805,10 @@ struct FrametimeGraphWindow : Window {
 	{
 		switch (widget) {
 			case WID_FGW_CAPTION:
-				if (this->element < PFE_AI0) {
-					return GetString(STR_FRAMETIME_CAPTION_GAMELOOP + this->element);
+				if (IsAIElement(this->element)) {
+					return GetString(STR_FRAMETIME_CAPTION_AI, this->element - PFE_AI0 + 1, GetAIName(this->element - PFE_AI0));
 				}
-				return GetString(STR_FRAMETIME_CAPTION_AI, this->element - PFE_AI0 + 1, GetAIName(this->element - PFE_AI0));
+				return GetString(GetElementString(this->element, STR_FRAMETIME_CAPTION_GAMELOOP, STR_FRAMETIME_CAPTION_AI));
 
 			default:
 				return this->Window::GetWidgetString(widget, stringid);
@@ -1065,6 +1111,8 @@ void ConPrintFramerate()
 		"Sound mixing",
 		"AI/GS scripts total",
 		"Game script",
+		"", "", "", "", "", "", "", "", "", "", "", "", "", "", "", // The AIs, see below.
+		"Link graph jobs",
 	};
 	std::string ai_name_buf;
 
@@ -1084,7 +1132,7 @@ void ConPrintFramerate()
 		auto &pf = _pf_data[e];
 		if (pf.num_valid == 0) continue;
 		std::string_view name;
-		if (e < PFE_AI0) {
+		if (!IsAIElement(e)) {
 			name = MEASUREMENT_NAMES[e];
 		} else {
 			ai_name_buf = fmt::format("AI {} {}", e - PFE_AI0 + 1, GetAIName(e - PFE_AI0));
@@ -1121,3 +1169,31 @@ void ProcessPendingPerformanceMeasurements()
 		_sound_perf_pending.store(false, std::memory_order_relaxed);
 	}
 }
+
+/**
+ * Summarise the most recent measurements of a performance element.
+ * @param elem The element to summarise.
+ * @param count The number of measurements to summarise.
+ * @return The summary; gaps in the measurements are skipped.
+ */
+PerformanceSummary GetPerformanceSummary(PerformanceElement elem, int count)
+{
+	const PerformanceData &pf = _pf_data[elem];
+	count = std::min(count, pf.num_valid);
+
+	int first_point = pf.prev_index - count;
+	if (first_point < 0) first_point += NUM_FRAMERATE_POINTS;
+
+	PerformanceSummary summary;
+	TimingMeasurement sum = 0;
+	for (int i = first_point; i < first_point + count; i++) {
+		TimingMeasurement duration = pf.durations[i % NUM_FRAMERATE_POINTS];
+		if (duration == PerformanceData::INVALID_DURATION) continue;
+
+		sum += duration;
+		summary.maximum = std::max(summary.maximum, duration);
+		summary.count++;
+	}
+	if (summary.count != 0) summary.average = sum / summary.count;
+	return summary;
+}
@@ -11,8 +11,9 @@
  * @par Adding new measurements
  * Adding a new measurement requires multiple steps, which are outlined here.
  * The first thing to do is add a new member of the #PerformanceElement enum.
- * It must be added before \c PFE_MAX and should be added in a logical place.
- * For example, an element of the game loop would be added next to the other game loop elements, and a rendering element next to the other rendering elements.
+ * It must be added just before \c PFE_MAX, as admin ports receive the values of this enum and existing values must keep their meaning.
+ * Where the element is shown in the framerate window is decided by \c DISPLAY_ORDER_PFE in framerate_gui.cpp,
+ * for example next to the other game loop elements for an element of the game loop.
  *
  * @par
  * Second is adding a member to the \link anonymous_namespace{framerate_gui.cpp}::_pf_data _pf_data \endlink array, in the same position as the new #PerformanceElement member.
@@ -21,6 +22,7 @@
  * Third is adding strings for the new element. There is an array in #ConPrintFramerate with strings used for the console command.
  * Additionally, there are two sets of strings in \c english.txt for two GUI uses, also in the #PerformanceElement order.
  * Search for \c STR_FRAMERATE_GAMELOOP and \c STR_FRAMETIME_CAPTION_GAMELOOP in \c english.txt to find those.
+ * The strings of elements after the AIs follow the strings of the AIs.
  *
  * @par
  * Last is actually adding the measurements. There are two ways to measure, either one-shot (a single function/block handling all processing),
@@ -74,6 +76,7 @@ enum PerformanceElement : uint8_t {
 	PFE_AI12,          ///< AI execution for player slot 13
 	PFE_AI13,          ///< AI execution for player slot 14
 	PFE_AI14,          ///< AI execution for player slot 15
+	PFE_LINKGRAPH_JOBS, ///< Time spent running link graph background jobs
 	PFE_MAX,           ///< End of enum, must be last.
 };
 DECLARE_INCREMENT_DECREMENT_OPERATORS(PerformanceElement)
@@ -97,6 +100,7 @@ public:
 	void SetExpectedRate(double rate);
 	static void SetInactive(PerformanceElement elem);
 	static void Paused(PerformanceElement elem);
+	static void AddMeasurement(PerformanceElement elem, TimingMeasurement duration);
 };
 
 /**
@@ -119,7 +123,15 @@ public:
 	static void Reset(PerformanceElement elem);
 };
 
+/** Summary of the most recent measurements of a performance element. */
+struct PerformanceSummary {
+	uint count = 0; ///< Number of valid measurements that were summarised.
+	TimingMeasurement average = 0; ///< Average duration, in microseconds.
+	TimingMeasurement maximum = 0; ///< Longest duration, in microseconds.
+};
+
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
+PerformanceSummary GetPerformanceSummary(PerformanceElement elem, int count);
 
 #endif /* FRAMERATE_TYPE_H */
@@ -16,6 +16,7 @@
 
 /**
  * Recalculates the cached total power of a vehicle. Should be called when the consist is changed.
+ * @pre The weights of the parts are calculated, see #CargoChanged.
  */
 template <class T, VehicleType Type>
 void GroundVehicle<T, Type>::PowerChanged()
@@ -33,7 +34,7 @@ void GroundVehicle<T, Type>::PowerChanged()
 		total_power += current_power;
 
 		/* Only powered parts add tractive effort. */
-		if (current_power > 0) max_te += u->GetWeight() * u->GetTractiveEffort();
+		if (current_power > 0) max_te += u->gcache.cached_part_weight * u->GetTractiveEffort();
 		number_of_parts++;
 
 		/* Get minimum max speed for this track. */
@@ -82,7 +83,8 @@ void GroundVehicle<T, Type>::CargoChanged()
 	uint32_t weight = 0;
 
 	for (T *u = T::From(this); u != nullptr; u = u->Next()) {
-		uint32_t current_weight = u->GetWeight();
+		u->gcache.cached_part_weight = u->GetWeight();
+		uint32_t current_weight = u->gcache.cached_part_weight;
 		weight += current_weight;
 		/* Slope steepness is in percent, result in N. */
 		u->gcache.cached_slope_resistance = current_weight * u->GetSlopeSteepness() * 100;
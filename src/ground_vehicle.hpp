@@ -25,7 +25,7 @@ enum AccelStatus : uint8_t {
 
 /**
  * Cached, frequently calculated values.
- * All of these values except cached_slope_resistance are set only for the first part of a vehicle.
+ * All of these values except cached_slope_resistance and cached_part_weight are set only for the first part of a vehicle.
  */
 struct GroundVehicleCache {
 	/* Cached acceleration values, recalculated when the cargo on a vehicle changes (in addition to the conditions below) */
@@ -33,6 +33,7 @@ struct GroundVehicleCache {
 	uint32_t cached_slope_resistance = 0; ///< Resistance caused by weight when this vehicle part is at a slope.
 	uint32_t cached_max_te = 0; ///< Maximum tractive effort of consist (valid only for the first engine).
 	uint16_t cached_axle_resistance = 0; ///< Resistance caused by the axles of the vehicle (valid only for the first engine).
+	uint16_t cached_part_weight = 0; ///< Weight of this vehicle part including its cargo.
 
 	/* Cached acceleration values, recalculated on load and each time a vehicle is added to/removed from the consist. */
 	uint16_t cached_max_track_speed = 0; ///< Maximum consist speed (in internal units) limited by track type (valid only for the first engine).
@@ -59,13 +59,13 @@ public:
 	/**
 	 * Get the effective supply of one node towards another one. In symmetric
 	 * distribution the supply of the other node is weighed in.
-	 * @param from The supplying node.
-	 * @param to The receiving node.
+	 * @param from_supply The supply of the supplying node.
+	 * @param to_supply The supply of the receiving node.
 	 * @return Effective supply.
 	 */
-	inline uint EffectiveSupply(const Node &from, const Node &to)
+	inline uint EffectiveSupply(uint from_supply, uint to_supply) const
 	{
-		return std::max(from.base.supply * std::max(1U, to.base.supply) * this->mod_size / 100 / this->demand_per_node, 1U);
+		return std::max(from_supply * std::max(1U, to_supply) * this->mod_size / 100 / this->demand_per_node, 1U);
 	}
 
 	/**
@@ -109,12 +109,12 @@ public:
 
 	/**
 	 * Get the effective supply of one node towards another one.
-	 * @param from The supplying node.
+	 * @param from_supply The supply of the supplying node.
 	 * @return Effective supply.
 	 */
-	inline uint EffectiveSupply(const Node &from, const Node &)
+	inline uint EffectiveSupply(uint from_supply, uint) const
 	{
-		return from.base.supply;
+		return from_supply;
 	}
 
 	/**
@@ -162,6 +162,53 @@ inline void Scaler::SetDemands(LinkGraphJob &job, NodeID from_id, NodeID to_id,
 	job[from_id].DeliverSupply(to_id, demand_forw);
 }
 
+/**
+ * Calculate the demand between a supplying node and some receiving nodes,
+ * before it is limited by the remaining supply. This only depends on the
+ * properties of the nodes, so it can be done for many nodes in one go.
+ * @param scaler Scaler to be used for scaling demands.
+ * @param from_id The supplying node.
+ * @param to_ids The receiving nodes.
+ * @param[out] base_demands The demand towards each receiving node, or 0 if the supply is too small for the distance.
+ */
+template <class Tscaler>
+void DemandCalculator::CalcBaseDemands(const Tscaler &scaler, NodeID from_id, std::span<const NodeID> to_ids, std::span<uint> base_demands) const
+{
+	assert(to_ids.size() == base_demands.size());
+
+	constexpr int32_t divisor_scale = 16;
+
+	const uint from_supply = this->node_supply[from_id];
+	const int32_t from_x = this->node_x[from_id];
+	const int32_t from_y = this->node_y[from_id];
+
+	for (size_t i = 0; i < to_ids.size(); ++i) {
+		const NodeID to_id = to_ids[i];
+
+		int32_t supply = scaler.EffectiveSupply(from_supply, this->node_supply[to_id]);
+		assert(supply > 0);
+
+		int32_t scaled_distance = this->base_distance;
+		if (this->mod_dist > 0) {
+			/* Same as DistanceMaxPlusManhattan, but on the coordinates cached in the dense arrays. */
+			const int32_t dx = std::abs(from_x - this->node_x[to_id]);
+			const int32_t dy = std::abs(from_y - this->node_y[to_id]);
+			const int32_t distance = std::max(dx, dy) + dx + dy;
+			/* Scale distance around base_distance by (mod_dist * (100 / 1024)).
+			 * mod_dist may be > 1024, so clamp result to be non-negative */
+			scaled_distance = std::max(0, this->base_distance + (((distance - this->base_distance) * this->mod_dist) / 1024));
+		}
+
+		/* Scale the accuracy by distance around accuracy / 2 */
+		const int32_t divisor = divisor_scale + ((this->accuracy * scaled_distance * divisor_scale) / (this->base_distance * 2));
+		assert(divisor >= divisor_scale);
+
+		/* Only distribute demand if effective supply / accuracy divisor >= 1.
+		 * Others are too small or too far away to be considered at first. */
+		base_demands[i] = (divisor <= (supply * divisor_scale)) ? (supply * divisor_scale) / divisor : 0;
+	}
+}
+
 /**
  * Do the actual demand calculation, called from constructor.
  * @param job Job to calculate the demands for.
@@ -171,18 +218,31 @@ template <class Tscaler>
 void DemandCalculator::CalcDemand(LinkGraphJob &job, Tscaler scaler)
 {
 	NodeList supplies;
-	NodeList demands;
 	uint num_supplies = 0;
 	uint num_demands = 0;
 
+	/* The demanding nodes are visited round-robin, each supplying node
+	 * continuing where the previous one stopped. Instead of a queue they are
+	 * kept in a vector, consumed from next_demand on, so the base demands of
+	 * the next few can be calculated in one go. */
+	std::vector<NodeID> demands;
+	size_t next_demand = 0;
+
+	this->node_supply.resize(job.Size());
+	this->node_x.resize(job.Size());
+	this->node_y.resize(job.Size());
+
 	for (NodeID node = 0; node < job.Size(); node++) {
 		scaler.AddNode(job[node]);
+		this->node_supply[node] = job[node].base.supply;
+		this->node_x[node] = TileX(job[node].base.xy);
+		this->node_y[node] = TileY(job[node].base.xy);
 		if (job[node].base.supply > 0) {
 			supplies.push(node);
 			num_supplies++;
 		}
 		if (job[node].base.demand > 0) {
-			demands.push(node);
+			demands.push_back(node);
 			num_demands++;
 		}
 	}
@@ -195,46 +255,41 @@ void DemandCalculator::CalcDemand(LinkGraphJob &job, Tscaler scaler)
 	scaler.SetDemandPerNode(num_demands);
 	uint chance = 0;
 
-	while (!supplies.empty() && !demands.empty()) {
+	std::array<uint, DEMAND_BLOCK_SIZE> base_demands;
+
+	while (!supplies.empty() && next_demand < demands.size()) {
 		NodeID from_id = supplies.front();
 		supplies.pop();
 
+		/* Drop the demands that have been consumed, so the vector doesn't keep on growing. */
+		if (next_demand > demands.size() / 2) {
+			demands.erase(demands.begin(), demands.begin() + next_demand);
+			next_demand = 0;
+		}
+		size_t block_begin = next_demand;
+		size_t block_end = next_demand;
+
 		for (uint i = 0; i < num_demands; ++i) {
-			assert(!demands.empty());
-			NodeID to_id = demands.front();
-			demands.pop();
+			assert(next_demand < demands.size());
+			if (next_demand == block_end) {
+				size_t count = std::min(DEMAND_BLOCK_SIZE, demands.size() - next_demand);
+				this->CalcBaseDemands(scaler, from_id, std::span(demands).subspan(next_demand, count), std::span(base_demands).first(count));
+				block_begin = next_demand;
+				block_end = next_demand + count;
+			}
+			NodeID to_id = demands[next_demand];
+			uint demand_forw = base_demands[next_demand - block_begin];
+			next_demand++;
+
 			if (from_id == to_id) {
 				/* Only one node with supply and demand left */
-				if (demands.empty() && supplies.empty()) return;
+				if (next_demand == demands.size() && supplies.empty()) return;
 
-				demands.push(to_id);
+				demands.push_back(to_id);
 				continue;
 			}
 
-			int32_t supply = scaler.EffectiveSupply(job[from_id], job[to_id]);
-			assert(supply > 0);
-
-			constexpr int32_t divisor_scale = 16;
-
-			int32_t scaled_distance = this->base_distance;
-			if (this->mod_dist > 0) {
-				const int32_t distance = DistanceMaxPlusManhattan(job[from_id].base.xy, job[to_id].base.xy);
-				/* Scale distance around base_distance by (mod_dist * (100 / 1024)).
-				 * mod_dist may be > 1024, so clamp result to be non-negative */
-				scaled_distance = std::max(0, this->base_distance + (((distance - this->base_distance) * this->mod_dist) / 1024));
-			}
-
-			/* Scale the accuracy by distance around accuracy / 2 */
-			const int32_t divisor = divisor_scale + ((this->accuracy * scaled_distance * divisor_scale) / (this->base_distance * 2));
-			assert(divisor >= divisor_scale);
-
-			uint demand_forw = 0;
-			if (divisor <= (supply * divisor_scale)) {
-				/* At first only distribute demand if
-				 * effective supply / accuracy divisor >= 1
-				 * Others are too small or too far away to be considered. */
-				demand_forw = (supply * divisor_scale) / divisor;
-			} else if (++chance > this->accuracy * num_demands * num_supplies) {
+			if (demand_forw == 0 && ++chance > this->accuracy * num_demands * num_supplies) {
 				/* After some trying, if there is still supply left, distribute
 				 * demand also to other nodes. */
 				demand_forw = 1;
@@ -245,7 +300,7 @@ void DemandCalculator::CalcDemand(LinkGraphJob &job, Tscaler scaler)
 			scaler.SetDemands(job, from_id, to_id, demand_forw);
 
 			if (scaler.HasDemandLeft(job[to_id])) {
-				demands.push(to_id);
+				demands.push_back(to_id);
 			} else {
 				num_demands--;
 			}
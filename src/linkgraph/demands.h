@@ -25,6 +25,16 @@ private:
 	int32_t mod_dist;      ///< Distance modifier, determines how much demands decrease with distance.
 	int32_t accuracy;      ///< Accuracy of the calculation.
 
+	std::vector<uint> node_supply; ///< Supply of each node.
+	std::vector<int32_t> node_x;   ///< X coordinate of each node.
+	std::vector<int32_t> node_y;   ///< Y coordinate of each node.
+
+	/** Number of demands that are calculated in one go. */
+	static constexpr size_t DEMAND_BLOCK_SIZE = 64;
+
+	template <class Tscaler>
+	void CalcBaseDemands(const Tscaler &scaler, NodeID from_id, std::span<const NodeID> to_ids, std::span<uint> base_demands) const;
+
 	template <class Tscaler>
 	void CalcDemand(LinkGraphJob &job, Tscaler scaler);
 };
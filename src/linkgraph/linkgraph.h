@@ -239,6 +239,24 @@ public:
 	 */
 	inline TimerGameEconomy::Date LastCompression() const { return this->last_compression; }
 
+	/**
+	 * Get the time the last job of this link graph took to run.
+	 * @return Run time in microseconds, or 0 if unknown.
+	 */
+	inline uint64_t LastJobRunTime() const { return this->last_job_run_time; }
+
+	/**
+	 * Remember the time a job of this link graph took to run.
+	 * @param run_time Run time in microseconds.
+	 */
+	inline void SetLastJobRunTime(uint64_t run_time) { this->last_job_run_time = run_time; }
+
+	/**
+	 * Get the number of jobs in a row that reused the flows of the previous job.
+	 * @return Number of incremental jobs since the last full recalculation.
+	 */
+	inline uint8_t IncrementalRuns() const { return this->incremental_runs; }
+
 	/**
 	 * Get the cargo type this component's link graph refers to.
 	 * @return Cargo type.
@@ -268,6 +286,8 @@ protected:
 	CargoType cargo = INVALID_CARGO; ///< Cargo of this component's link graph.
 	TimerGameEconomy::Date last_compression{}; ///< Last time the capacities and supplies were compressed.
 	NodeVector nodes{}; ///< Nodes in the component.
+	uint8_t incremental_runs = 0; ///< Number of jobs in a row that reused the flows of the previous job.
+	uint64_t last_job_run_time = 0; ///< Run time of the last job, in microseconds. Differs between clients, so it is not saved and only used to schedule the jobs.
 };
 
 #endif /* LINKGRAPH_H */
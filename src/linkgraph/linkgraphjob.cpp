@@ -12,6 +12,7 @@
 #include "../window_func.h"
 #include "linkgraphjob.h"
 #include "linkgraphschedule.h"
+#include "linkgraphworkers.h"
 
 #include "../safeguards.h"
 
@@ -41,6 +42,72 @@ LinkGraphJob::LinkGraphJob(LinkGraphJobID index, const LinkGraph &orig) :
 		settings(_settings_game.linkgraph),
 		join_date(TimerGameEconomy::date + (_settings_game.linkgraph.recalc_time / EconomyTime::SECONDS_PER_DAY))
 {
+	if (orig.IncrementalRuns() >= MAX_INCREMENTAL_RUNS) return;
+
+	this->SetPreviousFlows([&](NodeID node_id) -> const FlowStatMap * {
+		const Station *st = Station::GetIfValid(orig[node_id].station);
+		if (st == nullptr) return nullptr;
+		const GoodsEntry &ge = st->goods[orig.Cargo()];
+		if (ge.link_graph != orig.index || ge.node != node_id || !ge.HasData()) return nullptr;
+		return &ge.GetData().flows;
+	});
+}
+
+/**
+ * Remember the flows planned by the previous job, so the flows of sources not
+ * affected by changes in the link graph can be reused. Hops over links that
+ * are gone, or that have to carry much more than their capacity, are kept
+ * as invalid hops, marking their origin as affected.
+ * @param get_flows Function returning the flows at a node, or \c nullptr if there are none.
+ */
+void LinkGraphJob::SetPreviousFlows(const std::function<const FlowStatMap *(NodeID)> &get_flows)
+{
+	TypedIndexContainer<std::vector<NodeID>, StationID> station_to_node;
+	for (NodeID node_id = 0; node_id < this->Size(); ++node_id) {
+		StationID st = this->link_graph[node_id].station;
+		if (st >= station_to_node.size()) station_to_node.resize(st + 1, INVALID_NODE);
+		station_to_node[st] = node_id;
+	}
+	auto to_node = [&](StationID st) { return st < station_to_node.size() ? station_to_node[st] : INVALID_NODE; };
+
+	this->previous_flows.clear();
+	for (NodeID node_id = 0; node_id < this->Size(); ++node_id) {
+		const FlowStatMap *flows = get_flows(node_id);
+		if (flows == nullptr) continue;
+
+		const LinkGraph::BaseNode &node = this->link_graph[node_id];
+		size_t first = this->previous_flows.size();
+		for (const auto &[origin_station, flow] : *flows) {
+			NodeID origin = to_node(origin_station);
+			if (origin == INVALID_NODE) continue;
+
+			for (const auto &share : *flow.GetShares()) {
+				NodeID via = to_node(share.second);
+				if (via == node_id) continue; // Local consumption.
+				if (via != INVALID_NODE && (!node.HasEdgeTo(via) ||
+						flows->GetFlowVia(share.second) > this->link_graph.Monthly(node[via].capacity) * 3 / 2)) {
+					via = INVALID_NODE;
+				}
+				this->previous_flows.push_back({node_id, origin, via});
+			}
+		}
+		/* The flows are sorted by station, but they are looked up by node. */
+		std::stable_sort(this->previous_flows.begin() + first, this->previous_flows.end(),
+				[](const PreviousFlow &a, const PreviousFlow &b) { return a.origin < b.origin; });
+	}
+}
+
+/**
+ * Get the hops of the flows planned by the previous job from a node.
+ * @param node Node the flows pass.
+ * @param origin Node the flows started at.
+ * @return The hops, in the order of the shares of the previous flows.
+ */
+std::span<const LinkGraphJob::PreviousFlow> LinkGraphJob::GetPreviousFlows(NodeID node, NodeID origin) const
+{
+	auto range = std::ranges::equal_range(this->previous_flows, std::make_pair(node, origin), std::less{},
+			[](const PreviousFlow &flow) { return std::make_pair(flow.node, flow.origin); });
+	return {range.begin(), range.end()};
 }
 
 /**
@@ -55,31 +122,33 @@ void LinkGraphJob::EraseFlows(StationID from)
 }
 
 /**
- * Spawn a thread if possible and run the link graph job in the thread. If
- * that's not possible run the job right now in the current thread.
+ * Hand the job to the link graph worker threads. If that's not possible run
+ * the job right now in the current thread.
  */
 void LinkGraphJob::SpawnThread()
 {
-	if (!StartNewThread(&this->thread, "ottd:linkgraph", &(LinkGraphSchedule::Run), this)) {
-		/* Of course this will hang a bit.
-		 * On the other hand, if you want to play games which make this hang noticeably
-		 * on a platform without threads then you'll probably get other problems first.
-		 * OK:
-		 * If someone comes and tells me that this hangs for them, I'll implement a
-		 * smaller grained "Step" method for all handlers and add some more ticks where
-		 * "Step" is called. No problem in principle. */
-		LinkGraphSchedule::Run(this);
-	}
+	LinkGraphWorkers::Start(this);
 }
 
 /**
- * Join the calling thread with this job's thread if threading is enabled.
+ * Wait until the job has been run. If no worker thread picked it up yet, it
+ * is run right now in the current thread.
  */
 void LinkGraphJob::JoinThread()
 {
-	if (this->thread.joinable()) {
-		this->thread.join();
-	}
+	LinkGraphWorkers::Join(this);
+}
+
+/**
+ * Estimate how long the job will take to run, to schedule the big jobs first.
+ * The run time of the previous job of the same link graph is used if there
+ * has been one, otherwise the number of node pairs is taken as a rough guess.
+ * @return Estimated run time in microseconds.
+ */
+uint64_t LinkGraphJob::GetEstimatedRunTime() const
+{
+	if (this->link_graph.LastJobRunTime() != 0) return this->link_graph.LastJobRunTime();
+	return static_cast<uint64_t>(this->Size()) * this->Size();
 }
 
 /**
@@ -101,6 +170,9 @@ LinkGraphJob::~LinkGraphJob()
 	/* Link graph has been merged into another one. */
 	if (!LinkGraph::IsValidID(this->link_graph.index)) return;
 
+	LinkGraph *orig = LinkGraph::Get(this->link_graph.index);
+	orig->incremental_runs = this->incremental ? orig->incremental_runs + 1 : 0;
+
 	uint16_t size = this->Size();
 	for (NodeID node_id = 0; node_id < size; ++node_id) {
 		NodeAnnotation &from = this->nodes[node_id];
@@ -124,9 +196,9 @@ LinkGraphJob::~LinkGraphJob()
 		FlowStatMap &flows = from.flows;
 		FlowStatMap &geflows = ge.GetOrCreateData().flows;
 
-		for (const auto &edge : from.edges) {
+		for (const auto edge : from.Edges()) {
 			if (edge.Flow() == 0) continue;
-			NodeID dest_id = edge.base.dest_node;
+			NodeID dest_id = edge.DestNode();
 			StationID to = this->nodes[dest_id].base.station;
 			Station *st2 = Station::GetIfValid(to);
 			if (st2 == nullptr || st2->goods[this->Cargo()].link_graph != this->link_graph.index ||
@@ -184,9 +256,22 @@ LinkGraphJob::~LinkGraphJob()
 void LinkGraphJob::Init()
 {
 	uint size = this->Size();
+	EdgeStorage &edges = this->edges;
+	edges.first.reserve(size + 1);
+	for (uint i = 0; i < size; ++i) {
+		edges.first.push_back(static_cast<uint>(edges.dest_node.size()));
+		for (const auto &e : this->link_graph.nodes[i].edges) {
+			edges.dest_node.push_back(e.dest_node);
+			edges.capacity.push_back(e.capacity);
+			edges.travel_time.push_back(e.capacity != 0 ? e.TravelTime() : 0);
+		}
+	}
+	edges.first.push_back(static_cast<uint>(edges.dest_node.size()));
+	edges.flow.resize(edges.dest_node.size());
+
 	this->nodes.reserve(size);
 	for (uint i = 0; i < size; ++i) {
-		this->nodes.emplace_back(this->link_graph.nodes[i], this->link_graph.Size());
+		this->nodes.emplace_back(this->link_graph.nodes[i], size, edges, edges.first[i], edges.first[i + 1]);
 	}
 }
 
@@ -223,9 +308,9 @@ void Path::Fork(Path *base, uint cap, int free_cap, uint dist)
 uint Path::AddFlow(uint new_flow, LinkGraphJob &job, uint max_saturation)
 {
 	if (this->parent != nullptr) {
-		LinkGraphJob::EdgeAnnotation &edge = job[this->parent->node][this->node];
+		LinkGraphJob::EdgeAnnotation edge = job[this->parent->node][this->node];
 		if (max_saturation != UINT_MAX) {
-			uint usable_cap = edge.base.capacity * max_saturation / 100;
+			uint usable_cap = edge.Capacity() * max_saturation / 100;
 			if (usable_cap > edge.Flow()) {
 				new_flow = std::min(new_flow, usable_cap - edge.Flow());
 			} else {
@@ -10,9 +10,12 @@
 #ifndef LINKGRAPHJOB_H
 #define LINKGRAPHJOB_H
 
-#include "../thread.h"
 #include "linkgraph.h"
+#include "linkgraphschedule.h"
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <ranges>
 
 class LinkGraphJob;
 class Path;
@@ -37,25 +40,77 @@ public:
 	};
 
 	/**
-	 * Annotation for a link graph edge.
+	 * One hop of a flow planned by the previous job of the link graph. The
+	 * hops are used as routes by jobs that only recalculate the flows of
+	 * sources affected by changes in the link graph.
 	 */
-	struct EdgeAnnotation {
-		const LinkGraph::BaseEdge &base; ///< Reference to the edge that is annotated.
-		uint flow = 0; ///< Planned flow over this edge.
+	struct PreviousFlow {
+		NodeID node = INVALID_NODE; ///< Node the flow passes.
+		NodeID origin = INVALID_NODE; ///< Node the flow started at.
+		NodeID via = INVALID_NODE; ///< Next node of the flow, or INVALID_NODE if the link to it is gone or overloaded.
+	};
+
+	/**
+	 * Number of jobs in a row that may reuse the flows of the previous job,
+	 * before the flows are calculated from scratch again to pick up new links.
+	 */
+	static const uint8_t MAX_INCREMENTAL_RUNS = 3;
+
+	/**
+	 * The edges of all nodes of a job, in compressed sparse row form: the
+	 * edges of node n are at the indices [first[n], first[n + 1]), sorted by
+	 * destination. Every attribute has an array of its own, so the searches,
+	 * which mostly look at destinations and costs, don't have to load the
+	 * rest of the edges.
+	 */
+	struct EdgeStorage {
+		std::vector<uint> first{}; ///< Index of the first edge of each node, followed by the total number of edges.
+		std::vector<NodeID> dest_node{}; ///< Destination of each edge.
+		std::vector<uint> capacity{}; ///< Capacity of each edge.
+		std::vector<uint32_t> travel_time{}; ///< Average travel time of each edge, in ticks.
+		std::vector<uint> flow{}; ///< Planned flow over each edge.
+	};
+
+	/**
+	 * Annotation for a link graph edge. This is a small handle to the edge in
+	 * the job's edge storage, so it should be passed by value.
+	 */
+	class EdgeAnnotation {
+		EdgeStorage *storage; ///< Storage the edge is in.
+		uint index; ///< Index of the edge in the storage.
 
-		EdgeAnnotation(const LinkGraph::BaseEdge &base) : base(base) {}
+	public:
+		EdgeAnnotation(EdgeStorage &storage, uint index) : storage(&storage), index(index) {}
+
+		/**
+		 * Get the node the edge leads to.
+		 * @return Destination node.
+		 */
+		NodeID DestNode() const { return this->storage->dest_node[this->index]; }
+
+		/**
+		 * Get the capacity of the edge.
+		 * @return Capacity.
+		 */
+		uint Capacity() const { return this->storage->capacity[this->index]; }
+
+		/**
+		 * Get the average travel time of the edge.
+		 * @return Travel time, in ticks.
+		 */
+		uint32_t TravelTime() const { return this->storage->travel_time[this->index]; }
 
 		/**
 		 * Get the total flow on the edge.
 		 * @return Flow.
 		 */
-		uint Flow() const { return this->flow; }
+		uint Flow() const { return this->storage->flow[this->index]; }
 
 		/**
 		 * Add some flow.
 		 * @param flow Flow to be added.
 		 */
-		void AddFlow(uint flow) { this->flow += flow; }
+		void AddFlow(uint flow) { this->storage->flow[this->index] += flow; }
 
 		/**
 		 * Remove some flow.
@@ -63,13 +118,8 @@ public:
 		 */
 		void RemoveFlow(uint flow)
 		{
-			assert(flow <= this->flow);
-			this->flow -= flow;
-		}
-
-		friend inline bool operator <(NodeID dest, const EdgeAnnotation &rhs)
-		{
-			return dest < rhs.base.dest_node;
+			assert(flow <= this->storage->flow[this->index]);
+			this->storage->flow[this->index] -= flow;
 		}
 	};
 
@@ -83,26 +133,37 @@ public:
 		PathList paths{}; ///< Paths through this node, sorted so that those with flow == 0 are in the back.
 		FlowStatMap flows{}; ///< Planned flows to other nodes.
 
-		std::vector<EdgeAnnotation> edges{}; ///< Annotations for all edges originating at this node.
 		std::vector<DemandAnnotation> demands{}; ///< Annotations for the demand to all other nodes.
 
-		NodeAnnotation(const LinkGraph::BaseNode &node, size_t size) : base(node), undelivered_supply(node.supply)
+	private:
+		EdgeStorage *edge_storage; ///< Storage of the edges of the job.
+		uint first_edge; ///< Index of the first edge of this node in the storage.
+		uint end_edge; ///< Index behind the last edge of this node in the storage.
+
+	public:
+		NodeAnnotation(const LinkGraph::BaseNode &node, size_t size, EdgeStorage &edge_storage, uint first_edge, uint end_edge) :
+				base(node), undelivered_supply(node.supply), edge_storage(&edge_storage), first_edge(first_edge), end_edge(end_edge)
 		{
-			this->edges.reserve(node.edges.size());
-			for (auto &e : node.edges) this->edges.emplace_back(e);
 			this->demands.resize(size);
 		}
 
 		/**
-		 * Retrieve an edge starting at this node.
-		 * @param to Remote end of the edge.
-		 * @return Edge between this node and "to".
+		 * Get the destinations of all edges starting at this node, in ascending order.
+		 * @return Destinations, indexed like the edges.
 		 */
-		EdgeAnnotation &operator[](NodeID to)
+		std::span<const NodeID> EdgeDestinations() const
 		{
-			auto it = std::ranges::find_if(this->edges, [=] (const EdgeAnnotation &e) { return e.base.dest_node == to; });
-			assert(it != this->edges.end());
-			return *it;
+			return std::span<const NodeID>(this->edge_storage->dest_node).subspan(this->first_edge, this->end_edge - this->first_edge);
+		}
+
+		/**
+		 * Get all edges starting at this node.
+		 * @return Range of edge annotations.
+		 */
+		auto Edges() const
+		{
+			EdgeStorage *storage = this->edge_storage;
+			return std::views::iota(this->first_edge, this->end_edge) | std::views::transform([storage](uint index) { return EdgeAnnotation(*storage, index); });
 		}
 
 		/**
@@ -110,11 +171,12 @@ public:
 		 * @param to Remote end of the edge.
 		 * @return Edge between this node and "to".
 		 */
-		const EdgeAnnotation &operator[](NodeID to) const
+		EdgeAnnotation operator[](NodeID to) const
 		{
-			auto it = std::ranges::find_if(this->edges, [=] (const EdgeAnnotation &e) { return e.base.dest_node == to; });
-			assert(it != this->edges.end());
-			return *it;
+			std::span<const NodeID> dests = this->EdgeDestinations();
+			auto it = std::ranges::lower_bound(dests, to);
+			assert(it != dests.end() && *it == to);
+			return EdgeAnnotation(*this->edge_storage, this->first_edge + static_cast<uint>(it - dests.begin()));
 		}
 
 		/**
@@ -160,15 +222,22 @@ private:
 
 	friend SaveLoadTable GetLinkGraphJobDesc();
 	friend class LinkGraphSchedule;
+	friend class SlLinkgraphJobPreviousFlow;
 
 protected:
 	const LinkGraph link_graph; ///< Link graph to by analyzed. Is copied when job is started and mustn't be modified later.
 	const LinkGraphSettings settings; ///< Copy of _settings_game.linkgraph at spawn time.
-	std::thread thread{}; ///< Thread the job is running in or a default-constructed thread if it's running in the main thread.
 	TimerGameEconomy::Date join_date = EconomyTime::INVALID_DATE; ///< Date when the job is to be joined.
 	NodeAnnotationVector nodes{}; ///< Extra node data necessary for link graph calculation.
+	EdgeStorage edges{}; ///< Extra edge data necessary for link graph calculation.
 	std::atomic<bool> job_completed = false; ///< Is the job still running. This is accessed by multiple threads and reads may be stale.
 	std::atomic<bool> job_aborted = false; ///< Has the job been aborted. This is accessed by multiple threads and reads may be stale.
+	uint64_t run_time = 0; ///< Time it took to run the handlers, in microseconds. Only valid after the job has been joined.
+	std::vector<PreviousFlow> previous_flows{}; ///< Flows planned by the previous job, sorted by node and origin. Empty if the flows are calculated from scratch.
+	bool incremental = false; ///< Whether the flows of the previous job were reused. Only valid after the job has been joined.
+	LinkGraphJobProfile profile{}; ///< Measurements of the handlers. Only valid after the job has been joined.
+	size_t running_handler = 0; ///< Index of the handler that is running, for counting its iterations.
+	std::chrono::steady_clock::time_point completion_time{}; ///< Time the last handler finished. Only valid after the job has been joined.
 
 	void EraseFlows(StationID from);
 	void JoinThread();
@@ -186,6 +255,43 @@ public:
 	~LinkGraphJob();
 
 	void Init();
+	void SetPreviousFlows(const std::function<const FlowStatMap *(NodeID)> &get_flows);
+	std::span<const PreviousFlow> GetPreviousFlows(NodeID node, NodeID origin) const;
+
+	/**
+	 * Check if the flows of the previous job are available for reuse.
+	 * @return True if there are previous flows.
+	 */
+	inline bool HasPreviousFlows() const { return !this->previous_flows.empty(); }
+
+	/**
+	 * Check if the flows of the previous job were reused for the sources not affected by changes.
+	 * @return True if the flows were only partially recalculated.
+	 */
+	inline bool IsIncremental() const { return this->incremental; }
+
+	/**
+	 * Set whether the flows of the previous job are reused.
+	 * @param incremental Whether the flows are only partially recalculated.
+	 */
+	inline void SetIncremental(bool incremental) { this->incremental = incremental; }
+
+	/**
+	 * Count an iteration of the handler that is running, for the profile of the job.
+	 */
+	inline void CountIteration() { this->profile.handler_iterations[this->running_handler]++; }
+
+	/**
+	 * Get the measurements of the handlers. Only valid after the job has been joined.
+	 * @return The profile; the fields that are not about the handlers are filled in by the schedule.
+	 */
+	inline const LinkGraphJobProfile &Profile() const { return this->profile; }
+
+	/**
+	 * Get the time the last handler finished. Only valid after the job has been joined.
+	 * @return Completion time.
+	 */
+	inline std::chrono::steady_clock::time_point CompletionTime() const { return this->completion_time; }
 
 	/**
 	 * Check if job has actually finished.
@@ -227,6 +333,14 @@ public:
 	 */
 	inline void ShiftJoinDate(TimerGameEconomy::Date interval) { this->join_date += interval; }
 
+	uint64_t GetEstimatedRunTime() const;
+
+	/**
+	 * Get the time it took to run the job. Only valid after the job has been joined.
+	 * @return Run time in microseconds, or 0 if the job did not run to completion.
+	 */
+	inline uint64_t GetRunTime() const { return this->run_time; }
+
 	/**
 	 * Get the link graph settings for this component.
 	 * @return Settings.
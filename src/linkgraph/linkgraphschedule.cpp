@@ -27,6 +27,10 @@
  */
 /* static */ LinkGraphSchedule LinkGraphSchedule::instance;
 
+/* static */ const std::array<std::string_view, LinkGraphJobProfile::NUM_HANDLERS> LinkGraphSchedule::HANDLER_NAMES = {
+	"init", "demands", "mcf1", "flowmap1", "mcf2", "flowmap2",
+};
+
 /**
  * Start the next job in the schedule.
  */
@@ -72,24 +76,63 @@ void LinkGraphSchedule::JoinNext()
 	if (!next->IsScheduledToBeJoined()) return;
 	this->running.pop_front();
 	LinkGraphID id = next->LinkGraphIndex();
-	delete next; // implicitly joins the thread
+	auto join_time = std::chrono::steady_clock::now();
+	next->JoinThread();
+	uint64_t run_time = next->GetRunTime();
+	if (run_time != 0) this->RecordProfile(*next, join_time);
+	delete next;
 	if (LinkGraph::IsValidID(id)) {
 		LinkGraph *lg = LinkGraph::Get(id);
+		if (run_time != 0) lg->SetLastJobRunTime(run_time);
 		this->Dequeue(lg); // Dequeue to avoid double-queueing recycled IDs.
 		this->Queue(lg);
 	}
 }
 
+/**
+ * Keep the measurements of a job that has been joined.
+ * @param job The job, which has run to completion.
+ * @param join_time The time the game started to join the job.
+ */
+void LinkGraphSchedule::RecordProfile(const LinkGraphJob &job, std::chrono::steady_clock::time_point join_time)
+{
+	LinkGraphJobProfile profile = job.Profile();
+	profile.link_graph = job.LinkGraphIndex();
+	profile.cargo = job.Cargo();
+	profile.incremental = job.IsIncremental();
+	profile.run_time = job.GetRunTime();
+	profile.join_margin = std::chrono::duration_cast<std::chrono::microseconds>(join_time - job.CompletionTime()).count();
+	profile.join_date = TimerGameEconomy::date;
+
+	if (this->profiles.size() == MAX_PROFILES) this->profiles.pop_front();
+	this->profiles.push_back(profile);
+
+	PerformanceMeasurer::AddMeasurement(PFE_LINKGRAPH_JOBS, profile.run_time);
+}
+
 /**
  * Run all handlers for the given Job.
  * @param job Pointer to a link graph job.
  */
 /* static */ void LinkGraphSchedule::Run(LinkGraphJob *job)
 {
-	for (const auto &handler : instance.handlers) {
+	using namespace std::chrono;
+
+	auto start = steady_clock::now();
+	auto handler_start = start;
+	for (size_t i = 0; i < instance.handlers.size(); ++i) {
 		if (job->IsJobAborted()) return;
-		handler->Run(*job);
+		job->running_handler = i;
+		instance.handlers[i]->Run(*job);
+
+		auto handler_end = steady_clock::now();
+		job->profile.handler_times[i] = duration_cast<microseconds>(handler_end - handler_start).count();
+		handler_start = handler_end;
 	}
+	job->profile.nodes = job->Size();
+	job->profile.edges = static_cast<uint>(job->edges.dest_node.size());
+	job->completion_time = handler_start;
+	job->run_time = std::max<uint64_t>(duration_cast<microseconds>(handler_start - start).count(), 1);
 
 	/*
 	 * Readers of this variable in another thread may see an out of date value.
@@ -125,6 +168,7 @@ void LinkGraphSchedule::SpawnAll()
 	}
 	instance.running.clear();
 	instance.schedule.clear();
+	instance.profiles.clear();
 }
 
 /**
@@ -11,9 +11,29 @@
 #define LINKGRAPHSCHEDULE_H
 
 #include "linkgraph.h"
+#include <chrono>
 
 class LinkGraphJob;
 
+/**
+ * Measurements of a link graph job, to find out which jobs are slow and why.
+ */
+struct LinkGraphJobProfile {
+	/** Number of handlers that are run for each job. */
+	static constexpr size_t NUM_HANDLERS = 6;
+
+	LinkGraphID link_graph = LinkGraphID::Invalid(); ///< Link graph the job was run for.
+	CargoType cargo = INVALID_CARGO; ///< Cargo of the link graph.
+	uint nodes = 0; ///< Number of nodes of the link graph.
+	uint edges = 0; ///< Number of edges of the link graph.
+	bool incremental = false; ///< Whether the flows of the previous job were reused.
+	std::array<uint64_t, NUM_HANDLERS> handler_times{}; ///< Time spent in each handler, in microseconds.
+	std::array<uint, NUM_HANDLERS> handler_iterations{}; ///< Number of iterations of each handler; 0 for handlers that don't iterate.
+	uint64_t run_time = 0; ///< Time it took to run all handlers, in microseconds.
+	int64_t join_margin = 0; ///< Time between the job finishing and the game joining it, in microseconds. Negative if the game had to wait.
+	TimerGameEconomy::Date join_date{}; ///< Date the job was joined.
+};
+
 /**
  * A handler doing "something" on a link graph component. It must not keep any
  * state as it is called concurrently from different threads.
@@ -40,14 +60,19 @@ private:
 	friend SaveLoadTable GetLinkGraphScheduleDesc();
 
 protected:
-	std::array<std::unique_ptr<ComponentHandler>, 6> handlers{}; ///< Handlers to be run for each job.
+	std::array<std::unique_ptr<ComponentHandler>, LinkGraphJobProfile::NUM_HANDLERS> handlers{}; ///< Handlers to be run for each job.
 	GraphList schedule;            ///< Queue for new jobs.
 	JobList running;               ///< Currently running jobs.
+	std::deque<LinkGraphJobProfile> profiles; ///< Measurements of the most recently joined jobs, oldest first.
+
+	void RecordProfile(const LinkGraphJob &job, std::chrono::steady_clock::time_point join_time);
 
 public:
 	/* This is a tick where not much else is happening, so a small lag might go unnoticed. */
 	static const uint SPAWN_JOIN_TICK = 21; ///< Tick when jobs are spawned or joined every day.
 	static LinkGraphSchedule instance;
+	static const size_t MAX_PROFILES = 64; ///< Number of joined jobs to keep the measurements of.
+	static const std::array<std::string_view, LinkGraphJobProfile::NUM_HANDLERS> HANDLER_NAMES; ///< Names of the handlers, for in the profiles.
 
 	static void Run(LinkGraphJob *job);
 	static void Clear();
@@ -58,6 +83,12 @@ public:
 	void SpawnAll();
 	void ShiftDates(TimerGameEconomy::Date interval);
 
+	/**
+	 * Get the measurements of the most recently joined jobs.
+	 * @return The profiles, oldest first.
+	 */
+	const std::deque<LinkGraphJobProfile> &GetProfiles() const { return this->profiles; }
+
 	/**
 	 * Queue a link graph for execution.
 	 * @param lg Link graph to be queued.
@@ -0,0 +1,250 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file linkgraphworkers.cpp Definition of the threads running the link graph jobs. */
+
+#include "../stdafx.h"
+#include "linkgraphworkers.h"
+#include "linkgraphjob.h"
+#include "linkgraphschedule.h"
+#include "../thread.h"
+#include <atomic>
+#include <condition_variable>
+
+#include "../safeguards.h"
+
+/**
+ * Minimum number of threads. With a single thread one huge job would keep all
+ * others from starting, so on single core machines the threads share the core.
+ */
+static const uint MIN_LINK_GRAPH_WORKERS = 2;
+/** Maximum number of threads. */
+static const uint MAX_LINK_GRAPH_WORKERS = 8;
+
+/** Work of a job that is split into independent items. */
+struct LinkGraphParallelWork {
+	const std::function<void(size_t)> &func; ///< The function to call for each item.
+	size_t count; ///< The number of items.
+	uint64_t cost; ///< Estimated run time of the job the work belongs to.
+	std::atomic<size_t> next = 0; ///< The next item to handle.
+	uint busy = 0; ///< Number of helper threads working on the items.
+
+	/**
+	 * Create the work.
+	 * @param func The function to call for each item.
+	 * @param count The number of items.
+	 * @param cost Estimated run time of the job the work belongs to.
+	 */
+	LinkGraphParallelWork(const std::function<void(size_t)> &func, size_t count, uint64_t cost) : func(func), count(count), cost(cost) {}
+
+	/**
+	 * Check whether there are items left that nobody started on yet.
+	 * @return True if there are items left.
+	 */
+	bool HasItemsLeft() const { return this->next.load(std::memory_order_relaxed) < this->count; }
+
+	/** Handle items until none are left. */
+	void Work()
+	{
+		for (size_t i = this->next.fetch_add(1, std::memory_order_relaxed); i < this->count; i = this->next.fetch_add(1, std::memory_order_relaxed)) {
+			this->func(i);
+		}
+	}
+};
+
+/** Estimated run time of the job the current thread is running, or 0 if it is not running a job. */
+static thread_local uint64_t _current_job_cost = 0;
+
+/** A job that has been started, but that no thread picked up yet. */
+struct LinkGraphQueuedJob {
+	LinkGraphJob *job; ///< The job.
+	uint64_t cost; ///< Estimated run time of the job.
+};
+
+/** The state shared between the game and the worker threads. */
+struct LinkGraphWorkerState {
+	std::mutex lock; ///< Lock for everything below.
+	std::condition_variable work_available; ///< Signalled when a job or parallel work has been added, or the threads have to exit.
+	std::condition_variable work_done; ///< Signalled when a job finished, or a thread stopped working on parallel work.
+	std::vector<std::thread> threads; ///< The worker threads.
+	bool started = false; ///< Whether an attempt to start the threads has been made.
+	bool exit = false; ///< Whether the threads have to exit.
+
+	std::vector<LinkGraphQueuedJob> queue; ///< Jobs waiting for a thread.
+	std::vector<const LinkGraphJob *> running; ///< Jobs being run by a thread.
+	std::vector<LinkGraphParallelWork *> parallel_work; ///< Parallel work that threads can help with.
+
+	/**
+	 * Start the threads, if not done yet. Must be called with the lock held.
+	 * @return True if there are threads to run the work.
+	 */
+	bool StartThreads()
+	{
+		if (!this->started) {
+			this->started = true;
+			uint workers = Clamp(std::thread::hardware_concurrency(), MIN_LINK_GRAPH_WORKERS, MAX_LINK_GRAPH_WORKERS);
+			for (uint i = 0; i < workers; i++) {
+				std::thread thread;
+				if (!StartNewThread(&thread, "ottd:linkgraph", [](LinkGraphWorkerState *state) { state->Run(); }, this)) break;
+				this->threads.push_back(std::move(thread));
+			}
+		}
+		return !this->threads.empty();
+	}
+
+	/**
+	 * Find the parallel work of the job with the longest estimated run time, which still has items left.
+	 * @return The work, or \c nullptr if there is none.
+	 */
+	LinkGraphParallelWork *FindParallelWork() const
+	{
+		LinkGraphParallelWork *best = nullptr;
+		for (LinkGraphParallelWork *work : this->parallel_work) {
+			if (work->HasItemsLeft() && (best == nullptr || work->cost > best->cost)) best = work;
+		}
+		return best;
+	}
+
+	/**
+	 * Main loop of the worker threads. Jobs waiting for a thread are started
+	 * first, longest estimated run time first, so that every job gets going as
+	 * early as possible. Only when no job is waiting the threads help with the
+	 * parallel work of the running jobs.
+	 */
+	void Run()
+	{
+		std::unique_lock<std::mutex> lk(this->lock);
+		for (;;) {
+			this->work_available.wait(lk, [&]() { return this->exit || !this->queue.empty() || this->FindParallelWork() != nullptr; });
+			if (this->exit) return;
+
+			if (!this->queue.empty()) {
+				auto it = std::ranges::max_element(this->queue, {}, &LinkGraphQueuedJob::cost);
+				LinkGraphJob *job = it->job;
+				_current_job_cost = it->cost;
+				this->queue.erase(it);
+				this->running.push_back(job);
+
+				lk.unlock();
+				LinkGraphSchedule::Run(job);
+				lk.lock();
+
+				_current_job_cost = 0;
+				this->running.erase(std::ranges::find(this->running, job));
+				this->work_done.notify_all();
+				continue;
+			}
+
+			LinkGraphParallelWork *work = this->FindParallelWork();
+			work->busy++;
+			lk.unlock();
+			work->Work();
+			lk.lock();
+			if (--work->busy == 0) this->work_done.notify_all();
+		}
+	}
+
+	~LinkGraphWorkerState()
+	{
+		{
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->exit = true;
+		}
+		this->work_available.notify_all();
+		for (std::thread &thread : this->threads) thread.join();
+	}
+};
+
+/**
+ * Get the state of the worker threads; it is destroyed, and the threads joined, when the game exits.
+ * @return The state.
+ */
+static LinkGraphWorkerState &GetLinkGraphWorkerState()
+{
+	static LinkGraphWorkerState state;
+	return state;
+}
+
+/**
+ * Queue a job to be run by one of the worker threads. If there are no
+ * threads, the job is run right now in the calling thread.
+ * @param job The job to run.
+ */
+/* static */ void LinkGraphWorkers::Start(LinkGraphJob *job)
+{
+	LinkGraphWorkerState &state = GetLinkGraphWorkerState();
+
+	std::unique_lock<std::mutex> lk(state.lock);
+	if (!state.StartThreads()) {
+		lk.unlock();
+		/* Of course this will hang a bit.
+		 * On the other hand, if you want to play games which make this hang noticeably
+		 * on a platform without threads then you'll probably get other problems first.
+		 * OK:
+		 * If someone comes and tells me that this hangs for them, I'll implement a
+		 * smaller grained "Step" method for all handlers and add some more ticks where
+		 * "Step" is called. No problem in principle. */
+		LinkGraphSchedule::Run(job);
+		return;
+	}
+
+	state.queue.push_back({job, job->GetEstimatedRunTime()});
+	lk.unlock();
+	state.work_available.notify_all();
+}
+
+/**
+ * Wait until a job has been run. A job that no thread picked up yet is run
+ * right now in the calling thread, instead of waiting for a thread to become
+ * available.
+ * @param job The job to wait for.
+ */
+/* static */ void LinkGraphWorkers::Join(LinkGraphJob *job)
+{
+	LinkGraphWorkerState &state = GetLinkGraphWorkerState();
+
+	std::unique_lock<std::mutex> lk(state.lock);
+	auto it = std::ranges::find(state.queue, job, &LinkGraphQueuedJob::job);
+	if (it != state.queue.end()) {
+		state.queue.erase(it);
+		lk.unlock();
+		LinkGraphSchedule::Run(job);
+		return;
+	}
+
+	state.work_done.wait(lk, [&]() { return std::ranges::find(state.running, job) == state.running.end(); });
+}
+
+/**
+ * Call a function for each of a number of items, spread over the calling
+ * thread and the worker threads that have nothing else to do.
+ * @param count The number of items.
+ * @param func The function to call with the index of each item.
+ */
+/* static */ void LinkGraphWorkers::ParallelFor(size_t count, const std::function<void(size_t)> &func)
+{
+	LinkGraphWorkerState &state = GetLinkGraphWorkerState();
+
+	std::unique_lock<std::mutex> lk(state.lock);
+	if (count <= 1 || !state.StartThreads()) {
+		lk.unlock();
+		for (size_t i = 0; i < count; i++) func(i);
+		return;
+	}
+
+	LinkGraphParallelWork work(func, count, _current_job_cost);
+	state.parallel_work.push_back(&work);
+	lk.unlock();
+	state.work_available.notify_all();
+
+	work.Work();
+
+	/* Wait for the threads to finish the items they took, before the work goes out of scope. */
+	lk.lock();
+	state.parallel_work.erase(std::ranges::find(state.parallel_work, &work));
+	state.work_done.wait(lk, [&]() { return work.busy == 0; });
+}
@@ -0,0 +1,34 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file linkgraphworkers.h Declaration of the threads running the link graph jobs. */
+
+#ifndef LINKGRAPHWORKERS_H
+#define LINKGRAPHWORKERS_H
+
+#include <functional>
+
+class LinkGraphJob;
+
+/**
+ * Pool of threads that run the link graph jobs, and help them with work that
+ * can be split into independent items. The threads are started on first use
+ * and live until the game exits.
+ *
+ * The jobs with the longest estimated run time are started first, and idle
+ * threads help the running job with the longest estimated run time first.
+ * Which thread does what does not influence the results of the jobs, so it
+ * is allowed to differ between clients.
+ */
+class LinkGraphWorkers {
+public:
+	static void Start(LinkGraphJob *job);
+	static void Join(LinkGraphJob *job);
+	static void ParallelFor(size_t count, const std::function<void(size_t)> &func);
+};
+
+#endif /* LINKGRAPHWORKERS_H */
@@ -11,11 +11,29 @@
 #include "../core/math_func.hpp"
 #include "../timer/timer_game_tick.h"
 #include "mcf.h"
+#include "linkgraphworkers.h"
 
 #include "../safeguards.h"
 
 typedef std::map<NodeID, Path *> PathViaMap;
 
+/**
+ * Number of sources whose paths are searched at the same time, before any flow
+ * is pushed along them. It is fixed, so the flows do not depend on the number
+ * of threads doing the search.
+ */
+static const uint MCF_SOURCE_BATCH_SIZE = 16;
+
+/** Minimum number of nodes for the paths of multiple sources to be searched at the same time. */
+static const uint MCF_SOURCE_BATCH_MIN_NODES = 64;
+
+/**
+ * The flows of the previous job are only reused if at most one in this many
+ * sources is affected by changes in the link graph. Otherwise all flows are
+ * calculated from scratch.
+ */
+static const uint MCF_INCREMENTAL_MAX_AFFECTED_DIVISOR = 4;
+
 /**
  * Distance-based annotation for use in the Dijkstra algorithm. This is close
  * to the original meaning of "annotation" in this context. Paths are rated
@@ -45,7 +63,7 @@ public:
 	inline void UpdateAnnotation() { }
 
 	/**
-	 * Comparator for std containers.
+	 * Comparator for the priority queue of the Dijkstra algorithm.
 	 */
 	struct Comparator {
 		bool operator()(const DistanceAnnotation *x, const DistanceAnnotation *y) const;
@@ -87,7 +105,7 @@ public:
 	}
 
 	/**
-	 * Comparator for std containers.
+	 * Comparator for the priority queue of the Dijkstra algorithm.
 	 */
 	struct Comparator {
 		bool operator()(const CapacityAnnotation *x, const CapacityAnnotation *y) const;
@@ -102,8 +120,7 @@ class GraphEdgeIterator {
 private:
 	LinkGraphJob &job; ///< Job being executed
 
-	std::vector<LinkGraphJob::EdgeAnnotation>::const_iterator i;   ///< Iterator pointing to current edge.
-	std::vector<LinkGraphJob::EdgeAnnotation>::const_iterator end; ///< Iterator pointing beyond last edge.
+	std::span<const NodeID> dests; ///< Destinations of the edges that haven't been iterated yet.
 
 public:
 
@@ -111,7 +128,7 @@ public:
 	 * Construct a GraphEdgeIterator.
 	 * @param job Job to iterate on.
 	 */
-	GraphEdgeIterator(LinkGraphJob &job) : job(job), i(), end() {}
+	GraphEdgeIterator(LinkGraphJob &job) : job(job), dests() {}
 
 	/**
 	 * Setup the node to start iterating at.
@@ -119,8 +136,7 @@ public:
 	 */
 	void SetNode(NodeID, NodeID node)
 	{
-		this->i = this->job[node].edges.cbegin();
-		this->end = this->job[node].edges.cend();
+		this->dests = this->job[node].EdgeDestinations();
 	}
 
 	/**
@@ -129,7 +145,10 @@ public:
 	 */
 	NodeID Next()
 	{
-		return this->i != this->end ? (this->i++)->base.dest_node : INVALID_NODE;
+		if (this->dests.empty()) return INVALID_NODE;
+		NodeID dest = this->dests.front();
+		this->dests = this->dests.subspan(1);
+		return dest;
 	}
 };
 
@@ -148,6 +167,9 @@ private:
 
 	/** End of the shares map. */
 	FlowStat::SharesMap::const_iterator end;
+
+	/** Hops of the previous flows still to be iterated, if the node has no flows of the source. */
+	std::span<const LinkGraphJob::PreviousFlow> previous;
 public:
 
 	/**
@@ -177,9 +199,12 @@ public:
 		if (it != flows.end()) {
 			this->it = it->second.GetShares()->begin();
 			this->end = it->second.GetShares()->end();
+			this->previous = {};
 		} else {
 			this->it = FlowStat::empty_sharesmap.begin();
 			this->end = FlowStat::empty_sharesmap.end();
+			/* Sources whose flows were not recalculated keep the routes of the previous flows. */
+			this->previous = this->job.IsIncremental() ? this->job.GetPreviousFlows(node, source) : std::span<const LinkGraphJob::PreviousFlow>{};
 		}
 	}
 
@@ -189,8 +214,13 @@ public:
 	 */
 	NodeID Next()
 	{
-		if (this->it == this->end) return INVALID_NODE;
-		return this->station_to_node[(this->it++)->second];
+		if (this->it != this->end) return this->station_to_node[(this->it++)->second];
+		while (!this->previous.empty()) {
+			NodeID via = this->previous.front().via;
+			this->previous = this->previous.subspan(1);
+			if (via != INVALID_NODE) return via;
+		}
+		return INVALID_NODE;
 	}
 };
 
@@ -260,31 +290,30 @@ bool CapacityAnnotation::IsBetter(const CapacityAnnotation *base, uint cap,
  * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
  * @param source_node Node where the algorithm starts.
  * @param paths Container for the paths to be calculated.
+ * @param annos Empty priority queue to use; its storage is reused between runs.
  */
 template <class Tannotation, class Tedge_iterator>
-void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
+void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths, AnnotationHeap<Tannotation> &annos)
 {
-	typedef std::set<Tannotation *, typename Tannotation::Comparator> AnnoSet;
 	Tedge_iterator iter(this->job);
 	uint16_t size = this->job.Size();
-	AnnoSet annos;
+	assert(annos.IsEmpty());
+	annos.Reserve(size);
 	paths.resize(size, nullptr);
 	for (NodeID node = 0; node < size; ++node) {
 		Tannotation *anno = new Tannotation(node, node == source_node);
 		anno->UpdateAnnotation();
-		annos.insert(anno);
+		annos.Include(anno, node);
 		paths[node] = anno;
 	}
-	while (!annos.empty()) {
-		typename AnnoSet::iterator i = annos.begin();
-		Tannotation *source = *i;
-		annos.erase(i);
+	while (!annos.IsEmpty()) {
+		Tannotation *source = annos.Shift();
 		NodeID from = source->GetNode();
 		iter.SetNode(source_node, from);
 		for (NodeID to = iter.Next(); to != INVALID_NODE; to = iter.Next()) {
 			if (to == from) continue; // Not a real edge but a consumption sign.
-			const Edge &edge = this->job[from][to];
-			uint capacity = edge.base.capacity;
+			const Edge edge = this->job[from][to];
+			uint capacity = edge.Capacity();
 			if (this->max_saturation != UINT_MAX) {
 				capacity *= this->max_saturation;
 				capacity /= 100;
@@ -298,18 +327,123 @@ void MultiCommodityFlow::Dijkstra(NodeID source_node, PathVector &paths)
 				IsCargoInClass(this->job.Cargo(), CargoClass::Express);
 			uint distance = DistanceMaxPlusManhattan(this->job[from].base.xy, this->job[to].base.xy) + 1;
 			/* Compute a default travel time from the distance and an average speed of 1 tile/day. */
-			uint time = (edge.base.TravelTime() != 0) ? edge.base.TravelTime() + Ticks::DAY_TICKS : distance * Ticks::DAY_TICKS;
+			uint time = (edge.TravelTime() != 0) ? edge.TravelTime() + Ticks::DAY_TICKS : distance * Ticks::DAY_TICKS;
 			uint distance_anno = express ? time : distance;
 
 			Tannotation *dest = static_cast<Tannotation *>(paths[to]);
 			if (dest->IsBetter(source, capacity, capacity - edge.Flow(), distance_anno)) {
-				annos.erase(dest);
 				dest->Fork(source, capacity, capacity - edge.Flow(), distance_anno);
 				dest->UpdateAnnotation();
-				annos.insert(dest);
+				/* Nodes that were already visited are visited again, as their paths changed. */
+				if (annos.Contains(to)) {
+					annos.Update(to);
+				} else {
+					annos.Include(dest, to);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Get the number of sources whose paths are searched at the same time. Small
+ * link graphs are searched one source at a time, as before; splitting them
+ * up is not worth it.
+ * @return The number of sources in a batch.
+ */
+uint MultiCommodityFlow::GetSourceBatchSize() const
+{
+	return this->job.Size() < MCF_SOURCE_BATCH_MIN_NODES ? 1 : MCF_SOURCE_BATCH_SIZE;
+}
+
+/**
+ * Search the paths from a batch of sources, spread over the link graph worker
+ * threads. The searches only read the job, so they do not influence each other.
+ * @tparam Tannotation Annotation to be used.
+ * @tparam Tedge_iterator Iterator to be used for getting outgoing edges.
+ * @param first First source of the batch.
+ * @param batch_size Number of sources in a batch.
+ * @param finished_sources Sources that have no demand left and can be skipped.
+ * @param[out] sources The sources of the batch whose paths were searched.
+ * @param[out] paths The paths of each of the sources.
+ * @param heaps The priority queues for the searches, one for each source in a batch.
+ */
+template <class Tannotation, class Tedge_iterator>
+void MultiCommodityFlow::SearchPaths(uint first, uint batch_size, const std::vector<bool> &finished_sources, std::vector<NodeID> &sources, std::vector<PathVector> &paths, std::vector<AnnotationHeap<Tannotation>> &heaps)
+{
+	uint size = this->job.Size();
+
+	sources.clear();
+	for (uint source = first; source < size && source < first + batch_size; ++source) {
+		if (!finished_sources[source]) sources.push_back(static_cast<NodeID>(source));
+	}
+
+	paths.resize(sources.size());
+	LinkGraphWorkers::ParallelFor(sources.size(), [&](size_t i) {
+		this->Dijkstra<Tannotation, Tedge_iterator>(sources[i], paths[i], heaps[i]);
+	});
+}
+
+/**
+ * Find the sources whose flows can be taken over from the previous job: those
+ * whose previous flows use no links that are gone or overloaded, and reach
+ * all nodes the source has demand to. The other sources are affected by the
+ * changes in the link graph since the previous job.
+ * @param[out] unaffected_sources Sources whose flows don't have to be recalculated.
+ * @return True if few enough sources are affected to only recalculate their flows.
+ */
+bool MultiCommodityFlow::FindUnaffectedSources(std::vector<bool> &unaffected_sources)
+{
+	uint size = this->job.Size();
+	unaffected_sources.assign(size, false);
+	if (!this->job.HasPreviousFlows()) return false;
+
+	uint sources = 0;
+	uint affected = 0;
+	std::vector<bool> reached(size);
+	std::vector<NodeID> queue;
+	for (NodeID source = 0; source < size; ++source) {
+		Node &src_node = this->job[source];
+		bool has_demand = false;
+		for (NodeID dest = 0; dest < size && !has_demand; ++dest) has_demand = src_node.DemandTo(dest) > 0;
+		if (!has_demand) continue;
+		sources++;
+
+		/* Walk the previous flows of the source to see where they lead. */
+		bool valid = true;
+		std::fill(reached.begin(), reached.end(), false);
+		reached[source] = true;
+		queue.assign(1, source);
+		while (!queue.empty() && valid) {
+			NodeID node = queue.back();
+			queue.pop_back();
+			for (const LinkGraphJob::PreviousFlow &flow : this->job.GetPreviousFlows(node, source)) {
+				if (flow.via == INVALID_NODE) {
+					valid = false;
+					break;
+				}
+				if (!reached[flow.via]) {
+					reached[flow.via] = true;
+					queue.push_back(flow.via);
+				}
 			}
 		}
+		for (NodeID dest = 0; dest < size && valid; ++dest) {
+			if (src_node.DemandTo(dest) > 0 && !reached[dest]) valid = false;
+		}
+
+		if (valid) {
+			unaffected_sources[source] = true;
+		} else {
+			affected++;
+		}
 	}
+
+	if (affected * MCF_INCREMENTAL_MAX_AFFECTED_DIVISOR > sources) {
+		unaffected_sources.assign(size, false);
+		return false;
+	}
+	return true;
 }
 
 /**
@@ -400,7 +534,7 @@ void MCF1stPass::EliminateCycle(PathVector &path, Path *cycle_begin, uint flow)
 			}
 		}
 		cycle_begin = path[prev];
-		Edge &edge = this->job[prev][cycle_begin->GetNode()];
+		Edge edge = this->job[prev][cycle_begin->GetNode()];
 		edge.RemoveFlow(flow);
 	} while (cycle_begin != cycle_end);
 }
@@ -507,43 +641,53 @@ bool MCF1stPass::EliminateCycles()
  */
 MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
-	PathVector paths;
+	std::vector<NodeID> sources;
+	std::vector<PathVector> batch_paths;
 	uint16_t size = job.Size();
+	uint batch_size = this->GetSourceBatchSize();
+	std::vector<AnnotationHeap<DistanceAnnotation>> heaps(batch_size, AnnotationHeap<DistanceAnnotation>(size));
 	uint accuracy = job.Settings().accuracy;
 	bool more_loops;
 	std::vector<bool> finished_sources(size);
 
+	/* Sources not affected by changes keep their previous routes; their
+	 * demand is assigned to those in the second pass. */
+	job.SetIncremental(this->FindUnaffectedSources(finished_sources));
+
 	do {
+		job.CountIteration();
 		more_loops = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
-
+		for (uint first = 0; first < size; first += batch_size) {
 			/* First saturate the shortest paths. */
-			this->Dijkstra<DistanceAnnotation, GraphEdgeIterator>(source, paths);
-
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-					Path *path = paths[dest];
-					assert(path != nullptr);
-					/* Generally only allow paths that don't exceed the
-					 * available capacity. But if no demand has been assigned
-					 * yet, make an exception and allow any valid path *once*. */
-					if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
-							accuracy, this->max_saturation) > 0) {
-						/* If a path has been found there is a chance we can
-						 * find more. */
-						more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
-					} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
-							path->GetFreeCapacity() > INT_MIN) {
-						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+			this->SearchPaths<DistanceAnnotation, GraphEdgeIterator>(first, batch_size, finished_sources, sources, batch_paths, heaps);
+
+			for (size_t i = 0; i < sources.size(); ++i) {
+				NodeID source = sources[i];
+				PathVector &paths = batch_paths[i];
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+						Path *path = paths[dest];
+						assert(path != nullptr);
+						/* Generally only allow paths that don't exceed the
+						 * available capacity. But if no demand has been assigned
+						 * yet, make an exception and allow any valid path *once*. */
+						if (path->GetFreeCapacity() > 0 && this->PushFlow(src_node, dest, path,
+								accuracy, this->max_saturation) > 0) {
+							/* If a path has been found there is a chance we can
+							 * find more. */
+							more_loops = more_loops || (src_node.UnsatisfiedDemandTo(dest) > 0);
+						} else if (src_node.UnsatisfiedDemandTo(dest) == src_node.DemandTo(dest) &&
+								path->GetFreeCapacity() > INT_MIN) {
+							this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						}
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 					}
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) source_demand_left = true;
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	} while ((more_loops || this->EliminateCycles()) && !job.IsJobAborted());
 }
@@ -556,32 +700,38 @@ MCF1stPass::MCF1stPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 MCF2ndPass::MCF2ndPass(LinkGraphJob &job) : MultiCommodityFlow(job)
 {
 	this->max_saturation = UINT_MAX; // disable artificial cap on saturation
-	PathVector paths;
+	std::vector<NodeID> sources;
+	std::vector<PathVector> batch_paths;
 	uint16_t size = job.Size();
+	uint batch_size = this->GetSourceBatchSize();
+	std::vector<AnnotationHeap<CapacityAnnotation>> heaps(batch_size, AnnotationHeap<CapacityAnnotation>(size));
 	uint accuracy = job.Settings().accuracy;
 	bool demand_left = true;
 	std::vector<bool> finished_sources(size);
 	while (demand_left && !job.IsJobAborted()) {
+		job.CountIteration();
 		demand_left = false;
-		for (NodeID source = 0; source < size; ++source) {
-			if (finished_sources[source]) continue;
-
-			this->Dijkstra<CapacityAnnotation, FlowEdgeIterator>(source, paths);
-
-			Node &src_node = job[source];
-			bool source_demand_left = false;
-			for (NodeID dest = 0; dest < size; ++dest) {
-				Path *path = paths[dest];
-				if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
-					this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
-					if (src_node.UnsatisfiedDemandTo(dest) > 0) {
-						demand_left = true;
-						source_demand_left = true;
+		for (uint first = 0; first < size; first += batch_size) {
+			this->SearchPaths<CapacityAnnotation, FlowEdgeIterator>(first, batch_size, finished_sources, sources, batch_paths, heaps);
+
+			for (size_t i = 0; i < sources.size(); ++i) {
+				NodeID source = sources[i];
+				PathVector &paths = batch_paths[i];
+				Node &src_node = job[source];
+				bool source_demand_left = false;
+				for (NodeID dest = 0; dest < size; ++dest) {
+					Path *path = paths[dest];
+					if (src_node.UnsatisfiedDemandTo(dest) > 0 && path->GetFreeCapacity() > INT_MIN) {
+						this->PushFlow(src_node, dest, path, accuracy, UINT_MAX);
+						if (src_node.UnsatisfiedDemandTo(dest) > 0) {
+							demand_left = true;
+							source_demand_left = true;
+						}
 					}
 				}
+				finished_sources[source] = !source_demand_left;
+				this->CleanupPaths(source, paths);
 			}
-			finished_sources[source] = !source_demand_left;
-			this->CleanupPaths(source, paths);
 		}
 	}
 }
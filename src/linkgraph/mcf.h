@@ -11,9 +11,14 @@
 #define MCF_H
 
 #include "linkgraphjob_base.h"
+#include "../misc/indexedheap.hpp"
 
 typedef std::vector<Path *> PathVector;
 
+/** Priority queue of the annotations of the nodes, keyed by node ID. */
+template <class Tannotation>
+using AnnotationHeap = CIndexedHeapT<Tannotation, typename Tannotation::Comparator>;
+
 /**
  * Multi-commodity flow calculating base class.
  */
@@ -28,7 +33,14 @@ protected:
 	{}
 
 	template <class Tannotation, class Tedge_iterator>
-	void Dijkstra(NodeID from, PathVector &paths);
+	void Dijkstra(NodeID from, PathVector &paths, AnnotationHeap<Tannotation> &annos);
+
+	uint GetSourceBatchSize() const;
+
+	bool FindUnaffectedSources(std::vector<bool> &unaffected_sources);
+
+	template <class Tannotation, class Tedge_iterator>
+	void SearchPaths(uint first, uint batch_size, const std::vector<bool> &finished_sources, std::vector<NodeID> &sources, std::vector<PathVector> &paths, std::vector<AnnotationHeap<Tannotation>> &heaps);
 
 	uint PushFlow(Node &node, NodeID to, Path *path, uint accuracy, uint max_saturation);
 
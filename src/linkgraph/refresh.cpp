@@ -17,6 +17,52 @@
 
 #include "../safeguards.h"
 
+/** Memoised walks of order lists without refit orders. */
+static std::map<OrderListID, LinkRefreshMemo> _link_refresh_memos;
+
+/**
+ * Check whether two lists of orders are the same, as far as refreshing links is concerned.
+ * @param a The first list.
+ * @param b The second list.
+ * @return True if walking either list refreshes the same links.
+ */
+static bool IsSameForLinkRefresh(std::span<const Order> a, std::span<const Order> b)
+{
+	return std::ranges::equal(a, b, [](const Order &oa, const Order &ob) { return oa.Equals(ob) && oa.GetRefitCargo() == ob.GetRefitCargo(); });
+}
+
+/**
+ * Get the memoised walks of an order list. When the orders changed since the
+ * walks were done, they are forgotten.
+ * @param order_list The order list.
+ * @param orders The current orders of the order list.
+ * @return The memo of the order list.
+ */
+/* static */ LinkRefreshMemo &LinkRefresher::GetMemo(OrderListID order_list, std::span<const Order> orders)
+{
+	LinkRefreshMemo &memo = _link_refresh_memos[order_list];
+	if (!IsSameForLinkRefresh(memo.orders, orders)) {
+		memo.orders.assign(orders.begin(), orders.end());
+		memo.traversals.clear();
+	}
+	return memo;
+}
+
+/**
+ * Forget the memoised walks of an order list, e.g. because it is deleted.
+ * @param order_list The order list.
+ */
+/* static */ void LinkRefresher::InvalidateMemo(OrderListID order_list)
+{
+	_link_refresh_memos.erase(order_list);
+}
+
+/** Forget the memoised walks of all order lists, e.g. when a new game starts. */
+/* static */ void LinkRefresher::ResetMemos()
+{
+	_link_refresh_memos.clear();
+}
+
 /**
  * Refresh all links the given vehicle will visit.
  * @param v Vehicle to refresh links for.
@@ -34,8 +80,29 @@
 
 	HopSet seen_hops;
 	LinkRefresher refresher(v, &seen_hops, allow_merge, is_full_loading);
+	bool has_cargo = v->last_loading_station != StationID::Invalid();
+	RefreshFlags flags = has_cargo ? RefreshFlags{RefreshFlag::HasCargo} : RefreshFlags{};
+
+	/* Refits make the capacities, and with them the links, depend on the vehicle. */
+	std::span<const Order> orders = v->orders->GetOrders();
+	if (std::ranges::any_of(orders, &Order::IsRefit)) {
+		refresher.RefreshLinks(first, first, flags);
+		return;
+	}
+
+	/* Otherwise which links are refreshed only depends on the orders, so
+	 * vehicles sharing them can reuse what the first of them found. */
+	LinkRefreshMemo &memo = LinkRefresher::GetMemo(v->orders->index, orders);
+
+	auto it = std::ranges::find_if(memo.traversals, [&](const LinkRefreshTraversal &t) { return t.first == first && t.has_cargo == has_cargo; });
+	if (it == memo.traversals.end()) {
+		LinkRefreshTraversal &traversal = memo.traversals.emplace_back(first, has_cargo);
+		refresher.stats_hops = &traversal.stats_hops;
+		refresher.RefreshLinks(first, first, flags);
+		return;
+	}
 
-	refresher.RefreshLinks(first, first, v->last_loading_station != StationID::Invalid() ? RefreshFlags{RefreshFlag::HasCargo} : RefreshFlags{});
+	for (const auto &[cur, next] : it->stats_hops) refresher.RefreshStats(cur, next);
 }
 
 /**
@@ -47,7 +114,7 @@
  * @param is_full_loading If the vehicle is full loading.
  */
 LinkRefresher::LinkRefresher(Vehicle *vehicle, HopSet *seen_hops, bool allow_merge, bool is_full_loading) :
-	vehicle(vehicle), seen_hops(seen_hops), cargo(INVALID_CARGO), allow_merge(allow_merge),
+	vehicle(vehicle), seen_hops(seen_hops), stats_hops(nullptr), cargo(INVALID_CARGO), allow_merge(allow_merge),
 	is_full_loading(is_full_loading)
 {
 	/* Assemble list of capacities and set last loading stations to 0. */
@@ -305,6 +372,7 @@ void LinkRefresher::RefreshLinks(VehicleOrderID cur, VehicleOrderID next, Refres
 		if (cur_order->IsType(OT_GOTO_STATION) || cur_order->IsType(OT_IMPLICIT)) {
 			if (cur_order->CanLeaveWithCargo(flags.Test(RefreshFlag::HasCargo))) {
 				flags.Set(RefreshFlag::HasCargo);
+				if (this->stats_hops != nullptr) this->stats_hops->emplace_back(cur, next);
 				this->RefreshStats(cur, next);
 			} else {
 				flags.Reset(RefreshFlag::HasCargo);
@@ -13,6 +13,23 @@
 #include "../cargo_type.h"
 #include "../vehicle_base.h"
 
+/**
+ * Links refreshed by walking an order list from a specific order on. Without
+ * refit orders this only depends on the orders, so it can be reused for all
+ * vehicles sharing them.
+ */
+struct LinkRefreshTraversal {
+	VehicleOrderID first; ///< Order the walk started at.
+	bool has_cargo; ///< Whether the vehicle was carrying cargo when the walk started.
+	std::vector<std::pair<VehicleOrderID, VehicleOrderID>> stats_hops{}; ///< Pairs of orders link stats were refreshed for, in the order that happened.
+};
+
+/** The walks done for an order list, valid as long as the orders don't change. */
+struct LinkRefreshMemo {
+	std::vector<Order> orders{}; ///< Copy of the orders the walks were done for.
+	std::vector<LinkRefreshTraversal> traversals{}; ///< Walks done so far.
+};
+
 /**
  * Utility to refresh links a consist will visit.
  */
@@ -20,6 +37,10 @@ class LinkRefresher {
 public:
 	static void Run(Vehicle *v, bool allow_merge = true, bool is_full_loading = false);
 
+	static LinkRefreshMemo &GetMemo(OrderListID order_list, std::span<const Order> orders);
+	static void InvalidateMemo(OrderListID order_list);
+	static void ResetMemos();
+
 protected:
 	/**
 	 * Various flags about properties of the last examined link that might have
@@ -79,11 +100,13 @@ protected:
 
 	typedef std::vector<RefitDesc> RefitList;
 	typedef std::set<Hop> HopSet;
+	typedef std::vector<std::pair<VehicleOrderID, VehicleOrderID>> StatsHopList;
 
 	Vehicle *vehicle;           ///< Vehicle for which the links should be refreshed.
 	CargoArray capacities{}; ///< Current added capacities per cargo type in the consist.
 	RefitList refit_capacities; ///< Current state of capacity remaining from previous refits versus overall capacity per vehicle in the consist.
 	HopSet *seen_hops;          ///< Hops already seen. If the same hop is seen twice we stop the algorithm. This is shared between all Refreshers of the same run.
+	StatsHopList *stats_hops;   ///< If not nullptr, the pairs of orders link stats are refreshed for are recorded here. This is shared between all Refreshers of the same run.
 	CargoType cargo;              ///< Cargo given in last refit order.
 	bool allow_merge;           ///< If the refresher is allowed to merge or extend link graphs.
 	bool is_full_loading;       ///< If the vehicle is full loading.
@@ -25,9 +25,12 @@
 #include "tilehighlight_func.h"
 #include "network/network_func.h"
 #include "window_func.h"
+#include "vehicle_func.h"
 #include "core/pool_type.hpp"
 #include "game/game.hpp"
 #include "linkgraph/linkgraphschedule.h"
+#include "linkgraph/refresh.h"
+#include "pathfinder/yapf/yapf_cache.h"
 #include "station_kdtree.h"
 #include "town_kdtree.h"
 #include "viewport_kdtree.h"
@@ -41,7 +44,6 @@ extern void MakeNewgameSettingsLive();
 
 void InitializeSound();
 void InitializeMusic();
-void InitializeVehicles();
 void InitializeRailGui();
 void InitializeRoadGui();
 void InitializeAirportGui();
@@ -124,6 +126,8 @@ void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settin
 	}
 
 	LinkGraphSchedule::Clear();
+	LinkRefresher::ResetMemos();
+	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
 	PoolBase::Clean(PoolType::Normal);
 
 	RebuildStationKdtree();
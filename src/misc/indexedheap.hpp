@@ -0,0 +1,266 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file indexedheap.hpp Indexed d-ary heap implementation. */
+
+#ifndef INDEXEDHEAP_HPP
+#define INDEXEDHEAP_HPP
+
+/** Enable it if you suspect indexed heap doesn't work well */
+#define INDEXEDHEAP_CHECK 0
+
+/**
+ * Indexed d-ary Heap as C++ template.
+ *  Like CBinaryHeapT it keeps the smallest item at the first position, but
+ *  every item is also associated with a key in the range [0, capacity). The
+ *  position of each key in the heap is tracked, so an item can be found and
+ *  moved to its new place in logarithmic time after its value changed,
+ *  without having to search for it first.
+ *
+ * @par Usage information:
+ * Items are ordered by Tcomparator, which has the same meaning as the
+ * comparator of std::set: it returns true if the first item should be in
+ * front of the second one. When the value of an item that is in the heap
+ * changes, Update() must be called for its key.
+ *
+ * @par
+ * This heap allocates just the space for item pointers and the positions of
+ * the keys, both up front. The items are allocated elsewhere. The storage is
+ * meant to be reused for many runs, e.g. one Dijkstra run after another.
+ *
+ * @par Implementation notes:
+ * Each node has Tarity children, which makes the tree shallower than a binary
+ * one. That makes decreasing a key cheaper, at the cost of a few more
+ * comparisons when removing the first item.
+ *
+ * @tparam T Type of the items stored in the heap
+ * @tparam Tcomparator Comparator for pointers to the items
+ * @tparam Tarity Number of children of each node
+ */
+template <class T, class Tcomparator, size_t Tarity = 4>
+class CIndexedHeapT {
+	static_assert(Tarity >= 2);
+
+private:
+	static constexpr size_t NOT_IN_HEAP = SIZE_MAX; ///< Position of keys that are not in the heap.
+
+	std::vector<std::pair<T *, size_t>> data; ///< The items and their keys, in heap order.
+	std::vector<size_t> positions; ///< Position in data of each key.
+	Tcomparator comparator; ///< The comparator for the items.
+
+public:
+	/**
+	 * Create an indexed heap.
+	 * @param capacity The number of keys the heap can hold without growing.
+	 */
+	explicit CIndexedHeapT(size_t capacity = 0)
+	{
+		this->Reserve(capacity);
+	}
+
+protected:
+	/**
+	 * Put an item at a position in the heap.
+	 * @param pos The position.
+	 * @param entry The item and its key.
+	 */
+	inline void Place(size_t pos, const std::pair<T *, size_t> &entry)
+	{
+		this->data[pos] = entry;
+		this->positions[entry.second] = pos;
+	}
+
+	/**
+	 * Get position for fixing a gap (downwards).
+	 *  The gap is moved downwards in the tree until it
+	 *  is in order again.
+	 *
+	 * @param gap The position of the gap
+	 * @param item The proposed item for filling the gap
+	 * @return The (gap)position where the item fits
+	 */
+	inline size_t HeapifyDown(size_t gap, const T *item)
+	{
+		for (;;) {
+			size_t first_child = gap * Tarity + 1;
+			if (first_child >= this->data.size()) break;
+
+			/* choose the smallest child */
+			size_t child = first_child;
+			size_t last_child = std::min(first_child + Tarity, this->data.size());
+			for (size_t i = first_child + 1; i < last_child; i++) {
+				if (this->comparator(this->data[i].first, this->data[child].first)) child = i;
+			}
+			/* the smallest child is still bigger or same as the item => we are done */
+			if (!this->comparator(this->data[child].first, item)) break;
+
+			this->Place(gap, this->data[child]);
+			gap = child;
+		}
+		return gap;
+	}
+
+	/**
+	 * Get position for fixing a gap (upwards).
+	 *  The gap is moved upwards in the tree until it
+	 *  is in order again.
+	 *
+	 * @param gap The position of the gap
+	 * @param item The proposed item for filling the gap
+	 * @return The (gap)position where the item fits
+	 */
+	inline size_t HeapifyUp(size_t gap, const T *item)
+	{
+		while (gap > 0) {
+			size_t parent = (gap - 1) / Tarity;
+			/* we don't need to continue upstairs */
+			if (!this->comparator(item, this->data[parent].first)) break;
+
+			this->Place(gap, this->data[parent]);
+			gap = parent;
+		}
+		return gap;
+	}
+
+#if INDEXEDHEAP_CHECK
+	/** Verify the heap consistency */
+	inline void CheckConsistency() const
+	{
+		for (size_t pos = 0; pos < this->data.size(); pos++) {
+			assert(this->positions[this->data[pos].second] == pos);
+			if (pos > 0) assert(!this->comparator(this->data[pos].first, this->data[(pos - 1) / Tarity].first));
+		}
+	}
+#else
+	/** Don't check for consistency. */
+	inline void CheckConsistency() const {}
+#endif
+
+public:
+	/**
+	 * Make sure keys up to the given capacity can be used, without allocating
+	 * memory when including items.
+	 * @param capacity The number of keys.
+	 */
+	inline void Reserve(size_t capacity)
+	{
+		if (capacity <= this->positions.size()) return;
+		this->data.reserve(capacity);
+		this->positions.resize(capacity, NOT_IN_HEAP);
+	}
+
+	/**
+	 * Get the number of items stored in the heap.
+	 *
+	 * @return The number of items in the heap
+	 */
+	inline size_t Length() const
+	{
+		return this->data.size();
+	}
+
+	/**
+	 * Test if the heap is empty.
+	 *
+	 * @return True if empty
+	 */
+	inline bool IsEmpty() const
+	{
+		return this->data.empty();
+	}
+
+	/**
+	 * Test if an item with the given key is in the heap.
+	 *
+	 * @param key The key
+	 * @return True if the key is in the heap
+	 */
+	inline bool Contains(size_t key) const
+	{
+		return key < this->positions.size() && this->positions[key] != NOT_IN_HEAP;
+	}
+
+	/**
+	 * Get the smallest item in the heap.
+	 *
+	 * @return The smallest item, or throw assert if empty.
+	 */
+	inline T *Begin() const
+	{
+		assert(!this->IsEmpty());
+		return this->data.front().first;
+	}
+
+	/**
+	 * Insert new item into the heap, maintaining heap order.
+	 *
+	 * @param new_item The pointer to the new item
+	 * @param key The key of the new item, which must not be in the heap yet
+	 */
+	inline void Include(T *new_item, size_t key)
+	{
+		this->Reserve(key + 1);
+		assert(!this->Contains(key));
+
+		/* Make place for new item. A gap is now at the end of the tree. */
+		this->data.emplace_back();
+		size_t gap = this->HeapifyUp(this->data.size() - 1, new_item);
+		this->Place(gap, {new_item, key});
+		this->CheckConsistency();
+	}
+
+	/**
+	 * Remove and return the smallest (and also first) item
+	 *  from the heap.
+	 *
+	 * @return The pointer to the removed item
+	 */
+	inline T *Shift()
+	{
+		assert(!this->IsEmpty());
+
+		std::pair<T *, size_t> first = this->data.front();
+		std::pair<T *, size_t> last = this->data.back();
+		this->positions[first.second] = NOT_IN_HEAP;
+		this->data.pop_back();
+
+		/* at position 0 we have a gap now */
+		if (!this->IsEmpty()) this->Place(this->HeapifyDown(0, last.first), last);
+
+		this->CheckConsistency();
+		return first.first;
+	}
+
+	/**
+	 * Restore the heap order after the value of an item changed.
+	 *
+	 * @param key The key of the item, which must be in the heap
+	 */
+	inline void Update(size_t key)
+	{
+		assert(this->Contains(key));
+
+		std::pair<T *, size_t> entry = this->data[this->positions[key]];
+		size_t gap = this->HeapifyUp(this->positions[key], entry.first);
+		gap = this->HeapifyDown(gap, entry.first);
+		this->Place(gap, entry);
+
+		this->CheckConsistency();
+	}
+
+	/**
+	 * Make the heap empty.
+	 * All remaining items will remain untouched, the capacity is kept.
+	 */
+	inline void Clear()
+	{
+		for (const auto &entry : this->data) this->positions[entry.second] = NOT_IN_HEAP;
+		this->data.clear();
+	}
+};
+
+#endif /* INDEXEDHEAP_HPP */
@@ -12,8 +12,79 @@
 
 #include "packet.h"
 
+#include <mutex>
+
 #include "../../safeguards.h"
 
+/**
+ * Pool of buffers of destroyed packets, so sending and receiving packets does not
+ * need to allocate memory for every packet. Buffers of packets that may be larger
+ * than COMPAT_MTU are kept separately, so small packets do not hog large buffers.
+ */
+struct PacketBufferPool {
+	static constexpr size_t MAX_POOLED_BUFFERS = 64; ///< Maximum number of buffers to keep per size class.
+
+	std::mutex mutex; ///< Mutex as packets are made on several threads.
+	std::vector<std::vector<uint8_t>> small_buffers; ///< Buffers of packets with a limit up to COMPAT_MTU.
+	std::vector<std::vector<uint8_t>> large_buffers; ///< Buffers of packets with a larger limit.
+
+	/**
+	 * Get the buffers for packets with the given limit.
+	 * @param limit The limit of the packet.
+	 * @return The buffers of the size class.
+	 */
+	std::vector<std::vector<uint8_t>> &GetBuffers(size_t limit)
+	{
+		return limit <= COMPAT_MTU ? this->small_buffers : this->large_buffers;
+	}
+
+	/**
+	 * Get an empty buffer from the pool, or a new one when the pool is empty.
+	 * @param limit The limit of the packet to get the buffer for.
+	 * @return The empty buffer.
+	 */
+	std::vector<uint8_t> Acquire(size_t limit)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		auto &buffers = this->GetBuffers(limit);
+		if (buffers.empty()) return {};
+
+		std::vector<uint8_t> buffer = std::move(buffers.back());
+		buffers.pop_back();
+		return buffer;
+	}
+
+	/**
+	 * Return a buffer to the pool.
+	 * @param buffer The buffer to return.
+	 * @param limit The limit of the packet the buffer was used for.
+	 */
+	void Release(std::vector<uint8_t> &&buffer, size_t limit)
+	{
+		if (buffer.capacity() == 0) return;
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+
+		auto &buffers = this->GetBuffers(limit);
+		if (buffers.size() >= MAX_POOLED_BUFFERS) return;
+
+		buffer.clear();
+		buffers.push_back(std::move(buffer));
+	}
+};
+
+/**
+ * Get the pool with packet buffers. It is never destroyed, as packets of
+ * statically allocated socket handlers might otherwise outlive it.
+ * @return The pool.
+ */
+static PacketBufferPool &GetPacketBufferPool()
+{
+	static PacketBufferPool *pool = new PacketBufferPool();
+	return *pool;
+}
+
 /**
  * Create a packet that is used to read from a network socket.
  * @param cs                The socket handler associated with the socket we are reading from.
@@ -31,6 +102,7 @@ Packet::Packet(NetworkSocketHandler *cs, size_t limit, size_t initial_read_size)
 	assert(cs != nullptr);
 
 	this->cs = cs;
+	this->buffer = GetPacketBufferPool().Acquire(limit);
 	this->buffer.resize(initial_read_size);
 }
 
@@ -52,11 +124,18 @@ Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0)
 		size += cs->send_encryption_handler->MACSize();
 	}
 	assert(this->CanWriteToPacket(size));
+	this->buffer = GetPacketBufferPool().Acquire(limit);
 	this->buffer.resize(size, 0);
 
 	this->Send_uint8(type);
 }
 
+/** Return the buffer of the packet to the pool. */
+Packet::~Packet()
+{
+	GetPacketBufferPool().Release(std::move(this->buffer), this->limit);
+}
+
 
 /**
  * Writes the packet size from the raw packet from packet->size
@@ -77,7 +156,6 @@ void Packet::PrepareToSend()
 	}
 
 	this->pos  = 0; // We start reading from here
-	this->buffer.shrink_to_fit();
 }
 
 /**
@@ -199,6 +277,30 @@ std::span<const uint8_t> Packet::Send_bytes(const std::span<const uint8_t> span)
 	return span.subspan(amount);
 }
 
+/**
+ * Copy the shared encoding of the packet's content into the packet.
+ * @param payload The encoded content.
+ */
+void Packet::Send_payload(const PacketPayload &payload)
+{
+	assert(this->CanWriteToPacket(payload->size()));
+	this->buffer.insert(this->buffer.end(), payload->begin(), payload->end());
+}
+
+/**
+ * Get the content written to the packet so far, so it can be sent to
+ * several sockets with Send_payload. This can only be done for packets
+ * that are not associated with a socket.
+ * @return The encoded content.
+ */
+PacketPayload Packet::ToPayload() const
+{
+	assert(this->cs == nullptr);
+
+	size_t header_size = Packet::ENCODED_LENGTH_OF_PACKET_SIZE + Packet::ENCODED_LENGTH_OF_PACKET_TYPE;
+	return std::make_shared<const std::vector<uint8_t>>(this->buffer.begin() + header_size, this->buffer.end());
+}
+
 /*
  * Receiving commands
  * Again, the next couple of functions are endian-safe
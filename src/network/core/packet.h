@@ -19,6 +19,14 @@
 typedef uint16_t PacketSize; ///< Size of the whole packet.
 typedef uint8_t  PacketType; ///< Identifier for the packet
 
+/**
+ * Immutable, reference counted encoding of the content of a packet, i.e. everything
+ * after the packet's type. Content that is sent to many sockets is encoded once, and
+ * then only copied into the packet for each socket, as every socket has its own
+ * encryption of the packet.
+ */
+using PacketPayload = std::shared_ptr<const std::vector<uint8_t>>;
+
 /**
  * Trait to mark an enumeration as a PacketType.
  *
@@ -83,6 +91,10 @@ public:
 	template <typename E, typename = std::enable_if_t<IsEnumPacketType<E>::value>>
 	Packet(NetworkSocketHandler *cs, E type, size_t limit = COMPAT_MTU) : Packet(cs, to_underlying(type), limit) {}
 
+	~Packet();
+	Packet(Packet &&) = default;
+	Packet &operator=(Packet &&) = default;
+
 	/* Sending/writing of packets */
 	void PrepareToSend();
 
@@ -97,6 +109,8 @@ public:
 	void   Send_string(std::string_view data);
 	void   Send_buffer(const std::vector<uint8_t> &data);
 	std::span<const uint8_t> Send_bytes(const std::span<const uint8_t> span);
+	void   Send_payload(const PacketPayload &payload);
+	PacketPayload ToPayload() const;
 
 	/* Reading/receiving of packets */
 	bool HasPacketSizeData() const;
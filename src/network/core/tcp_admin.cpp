@@ -78,6 +78,10 @@ NetworkRecvStatus NetworkAdminSocketHandler::HandlePacket(Packet &p)
 		case PacketAdminType::ServerPong: return this->ReceiveServerPong(p);
 		case PacketAdminType::ServerAuthenticationRequest: return this->ReceiveServerAuthenticationRequest(p);
 		case PacketAdminType::ServerEnableEncryption: return this->ReceiveServerEnableEncryption(p);
+		case PacketAdminType::ServerVehicles: return this->ReceiveServerVehicles(p);
+		case PacketAdminType::ServerStations: return this->ReceiveServerStations(p);
+		case PacketAdminType::ServerLinkGraph: return this->ReceiveServerLinkGraph(p);
+		case PacketAdminType::ServerPerformance: return this->ReceiveServerPerformance(p);
 
 		default:
 			Debug(net, 0, "[tcp/admin] Received invalid packet type {} from '{}' ({})", type, this->admin_name, this->admin_version);
@@ -156,3 +160,7 @@ NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerRemoteConsoleCommandEn
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerPong(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerPong); }
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerAuthenticationRequest(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerAuthenticationRequest); }
 NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerEnableEncryption(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerEnableEncryption); }
+NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerVehicles(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerVehicles); }
+NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerStations(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerStations); }
+NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerLinkGraph(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerLinkGraph); }
+NetworkRecvStatus NetworkAdminSocketHandler::ReceiveServerPerformance(Packet &) { return this->ReceiveInvalidPacket(PacketAdminType::ServerPerformance); }
@@ -63,6 +63,10 @@ enum class PacketAdminType : uint8_t {
 	ServerCommandLogging, ///< The server gives the admin copies of incoming command packets.
 	ServerAuthenticationRequest, ///< The server gives the admin the used authentication method and required parameters.
 	ServerEnableEncryption, ///< The server tells that authentication has completed and requests to enable encryption with the keys of the last \c PacketAdminType::AdminAuthenticationResponse.
+	ServerVehicles, ///< The server gives the admin the vehicles that changed.
+	ServerStations, ///< The server gives the admin the stations that changed.
+	ServerLinkGraph, ///< The server gives the admin the edges of a link graph.
+	ServerPerformance, ///< The server gives the admin the time spent in the parts of the game loop.
 };
 /** Mark PacketAdminType as a PacketType. */
 template <> struct IsEnumPacketType<PacketAdminType> {
@@ -89,6 +93,10 @@ enum AdminUpdateType : uint8_t {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_VEHICLES,        ///< The admin would like to have the changes of the vehicles.
+	ADMIN_UPDATE_STATIONS,        ///< The admin would like to have the changes of the stations.
+	ADMIN_UPDATE_LINK_GRAPH,      ///< The admin would like to have the edges of the link graphs.
+	ADMIN_UPDATE_PERFORMANCE,     ///< The admin would like to have the performance measurements.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -531,6 +539,71 @@ protected:
 	 */
 	virtual NetworkRecvStatus ReceiveServerPong(Packet &p);
 
+	/**
+	 * Send the vehicles that changed since they were last sent. Only primary vehicles
+	 * are sent, with the cargo of the whole consist. Multiple of these packets can
+	 * follow each other; each holds records until the end of the packet:
+	 * uint32_t  ID of the vehicle.
+	 * bool      Whether the vehicle exists; when it does not, the record ends here.
+	 * uint8_t   Type of the vehicle (see #VehicleType).
+	 * uint8_t   ID of the company owning the vehicle.
+	 * uint16_t  Unit number of the vehicle.
+	 * uint32_t  Tile the vehicle is on.
+	 * uint16_t  Speed of the vehicle, as displayed.
+	 * uint32_t  Amount of cargo in the vehicle.
+	 * uint8_t   Flags: bit 0 stopped, bit 1 crashed, bit 2 in depot.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveServerVehicles(Packet &p);
+
+	/**
+	 * Send the stations that changed since they were last sent. Multiple of these
+	 * packets can follow each other; each holds records until the end of the packet:
+	 * uint16_t  ID of the station.
+	 * bool      Whether the station exists; when it does not, the record ends here.
+	 * uint8_t   ID of the company owning the station.
+	 * uint8_t   Number of cargoes with a rating at the station.
+	 * For each cargo:
+	 *   uint8_t   Cargo type.
+	 *   uint8_t   Rating of the cargo, 255 being 100%.
+	 *   uint32_t  Amount of cargo waiting.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveServerStations(Packet &p);
+
+	/**
+	 * Send the edges of a link graph. A link graph can be spread over multiple of these
+	 * packets; the edges of the link graph are replaced by those in the first packet:
+	 * uint16_t  ID of the link graph.
+	 * uint8_t   Cargo type of the link graph.
+	 * bool      Whether this is the first packet of this link graph. The other packets of it may follow in later ticks.
+	 * Edges until the end of the packet:
+	 *   uint16_t  ID of the station the edge starts at.
+	 *   uint16_t  ID of the station the edge ends at.
+	 *   uint32_t  Capacity of the edge.
+	 *   uint32_t  Usage of the edge.
+	 *   uint32_t  Average travel time over the edge, in ticks.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveServerLinkGraph(Packet &p);
+
+	/**
+	 * Send the time spent in the parts of the game loop:
+	 * uint16_t  Number of measurements (ticks) each element is summarised over.
+	 * uint8_t   Number of elements.
+	 * For each element:
+	 *   uint8_t   The element (see #PerformanceElement, new elements are only added at its end).
+	 *   uint16_t  Number of valid measurements.
+	 *   uint32_t  Average duration, in microseconds.
+	 *   uint32_t  Longest duration, in microseconds.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveServerPerformance(Packet &p);
+
 	/**
 	 * Notify the admin connection that the rcon command has finished.
 	 * string The command as requested by the admin connection.
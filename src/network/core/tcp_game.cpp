@@ -105,6 +105,7 @@ NetworkRecvStatus NetworkGameSocketHandler::HandlePacket(Packet &p)
 		case PacketGameType::ServerMove: return this->ReceiveServerMove(p);
 		case PacketGameType::ClientMove: return this->ReceiveClientMove(p);
 		case PacketGameType::ServerConfigurationUpdate: return this->ReceiveServerConfigurationUpdate(p);
+		case PacketGameType::ClientStateHash: return this->ReceiveClientStateHash(p);
 
 		default:
 			Debug(net, 0, "[tcp/game] Received invalid packet type {} from client {}", type, this->client_id);
@@ -184,6 +185,7 @@ NetworkRecvStatus NetworkGameSocketHandler::ReceiveClientNewGRFsChecked(Packet &
 NetworkRecvStatus NetworkGameSocketHandler::ReceiveServerMove(Packet &) { return this->ReceiveInvalidPacket(PacketGameType::ServerMove); }
 NetworkRecvStatus NetworkGameSocketHandler::ReceiveClientMove(Packet &) { return this->ReceiveInvalidPacket(PacketGameType::ClientMove); }
 NetworkRecvStatus NetworkGameSocketHandler::ReceiveServerConfigurationUpdate(Packet &) { return this->ReceiveInvalidPacket(PacketGameType::ServerConfigurationUpdate); }
+NetworkRecvStatus NetworkGameSocketHandler::ReceiveClientStateHash(Packet &) { return this->ReceiveInvalidPacket(PacketGameType::ClientStateHash); }
 
 /** Mark this socket handler for deletion, once iterating the socket handlers is done. */
 void NetworkGameSocketHandler::DeferDeletion()
@@ -120,6 +120,9 @@ enum class PacketGameType : uint8_t {
 	ServerQuit, ///< A server tells that a client has quit.
 	ClientError, ///< A client reports an error to the server.
 	ServerErrorQuit, ///< A server tells that a client has hit an error and did quit.
+
+	/* Desync investigation. */
+	ClientStateHash, ///< A client reports the hashes of its game state.
 };
 /** Mark PacketGameType as PacketType. */
 template <> struct IsEnumPacketType<PacketGameType> {
@@ -332,6 +335,7 @@ protected:
 	 * uint32_t  Frame counter.
 	 * uint32_t  General seed 1.
 	 * uint32_t  General seed 2 (dependent on compile settings, not default).
+	 * bool      Whether the client should report its state hashes.
 	 * @param p The packet that was just received.
 	 * @return The state the network should have.
 	 */
@@ -520,6 +524,18 @@ protected:
 	 */
 	virtual NetworkRecvStatus ReceiveServerConfigurationUpdate(Packet &p);
 
+	/**
+	 * Tell the server the hashes of the game state over the epochs that completed since the last report:
+	 * uint8_t   Number of epochs.
+	 * For each epoch:
+	 *   uint32_t  First frame of the epoch.
+	 *   uint8_t   Number of subsystems.
+	 *   uint64_t  Hash of each subsystem.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus ReceiveClientStateHash(Packet &p);
+
 	NetworkRecvStatus HandlePacket(Packet &p);
 
 	NetworkGameSocketHandler(SOCKET s);
@@ -562,7 +578,7 @@ public:
 	NetworkRecvStatus ReceivePackets();
 
 	std::optional<std::string_view> ReceiveCommand(Packet &p, CommandPacket &cp);
-	void SendCommand(Packet &p, const CommandPacket &cp);
+	static void SendCommand(Packet &p, const CommandPacket &cp);
 
 	/**
 	 * Is this pending for deletion and as such should not be accessed anymore.
@@ -22,6 +22,7 @@
 #include "network_gamelist.h"
 #include "network_base.h"
 #include "network_coordinator.h"
+#include "network_state_hash.h"
 #include "core/udp.h"
 #include "core/host.h"
 #include "network_gui.h"
@@ -69,6 +70,7 @@ bool _network_server;     ///< network-server is active
 bool _network_available;  ///< is network mode available?
 bool _network_dedicated;  ///< are we a dedicated server?
 bool _is_network_server;  ///< Does this client wants to be a network-server?
+bool _network_catching_up; ///< is the client running the frames it missed while joining?
 ClientID _network_own_client_id;      ///< Our client identifier.
 ClientID _redirect_console_to_client; ///< If not invalid, redirect the console output to a client.
 uint8_t _network_reconnect;             ///< Reconnect timeout
@@ -953,6 +955,7 @@ bool NetworkServerStart()
 	_frame_counter_server = 0;
 	_frame_counter_max = 0;
 	_last_sync_frame = 0;
+	NetworkStateHashReset();
 	_network_own_client_id = CLIENT_ID_SERVER;
 
 	_network_clients_connected = 0;
@@ -1292,6 +1295,8 @@ void NetworkGameLoop()
 		/* Then we make the frame */
 		StateGameLoop();
 
+		if (_settings_client.network.sync_state_hash) NetworkStateHashTick();
+
 		_sync_seed_1 = _random.state[0];
 #ifdef NETWORK_SEND_DOUBLE_SEED
 		_sync_seed_2 = _random.state[1];
@@ -1301,8 +1306,11 @@ void NetworkGameLoop()
 	} else {
 		/* Client */
 
-		/* Make sure we are at the frame were the server is (quick-frames) */
-		if (_frame_counter_server > _frame_counter) {
+		if (_network_catching_up) {
+			/* Run the frames we missed while joining as fast as possible. */
+			if (!ClientNetworkGameSocketHandler::CatchUpLoop()) return;
+		} else if (_frame_counter_server > _frame_counter) {
+			/* Make sure we are at the frame were the server is (quick-frames) */
 			/* Run a number of frames; when things go bad, get out. */
 			while (_frame_counter_server > _frame_counter) {
 				if (!ClientNetworkGameSocketHandler::GameLoop()) return;
@@ -22,6 +22,11 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../vehicle_base.h"
+#include "../station_base.h"
+#include "../framerate_type.h"
+#include "../timer/timer_game_tick.h"
+#include "../linkgraph/linkgraph.h"
 
 #include "table/strings.h"
 
@@ -56,6 +61,10 @@ static const AdminUpdateFrequencies _admin_update_type_frequencies[] = {
 	{AdminUpdateFrequency::Poll,                                                                                                                                                          }, // ADMIN_UPDATE_CMD_NAMES
 	{                            AdminUpdateFrequency::Automatic,                                                                                                                         }, // ADMIN_UPDATE_CMD_LOGGING
 	{                            AdminUpdateFrequency::Automatic,                                                                                                                         }, // ADMIN_UPDATE_GAMESCRIPT
+	{AdminUpdateFrequency::Poll, AdminUpdateFrequency::Daily, AdminUpdateFrequency::Weekly, AdminUpdateFrequency::Monthly,                                                                  }, // ADMIN_UPDATE_VEHICLES
+	{AdminUpdateFrequency::Poll, AdminUpdateFrequency::Daily, AdminUpdateFrequency::Weekly, AdminUpdateFrequency::Monthly,                                                                  }, // ADMIN_UPDATE_STATIONS
+	{AdminUpdateFrequency::Poll,                              AdminUpdateFrequency::Weekly, AdminUpdateFrequency::Monthly, AdminUpdateFrequency::Quarterly,                                }, // ADMIN_UPDATE_LINK_GRAPH
+	{AdminUpdateFrequency::Poll, AdminUpdateFrequency::Automatic, AdminUpdateFrequency::Daily,                                                                                              }, // ADMIN_UPDATE_PERFORMANCE
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -178,6 +187,13 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendProtocol()
  */
 NetworkRecvStatus ServerNetworkAdminSocketHandler::SendWelcome()
 {
+	/* Whatever was streamed before belongs to another game. */
+	this->vehicle_stream = {};
+	this->station_stream = {};
+	this->link_graph_cursor = 0;
+	this->link_graph_node = 0;
+	this->link_graph_edge = 0;
+
 	auto p = std::make_unique<Packet>(this, PacketAdminType::ServerWelcome);
 
 	p->Send_string(_settings_client.network.server_name);
@@ -658,6 +674,270 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdLogging(ClientID clien
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Refill the budget for bulk updates for the time passed since the last refill. */
+void ServerNetworkAdminSocketHandler::RefillTelemetryBudget()
+{
+	int64_t rate = static_cast<int64_t>(_settings_client.network.admin_telemetry_rate) * 1024;
+	auto now = std::chrono::steady_clock::now();
+	int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - this->telemetry_refill_time).count();
+	this->telemetry_refill_time = now;
+
+	/* Never save up more than a second worth of data, so bursts stay limited. */
+	this->telemetry_budget = std::min(rate, this->telemetry_budget + rate * std::min<int64_t>(elapsed, 1000) / 1000);
+}
+
+/**
+ * Mix a value into a fingerprint.
+ * @param fingerprint The fingerprint to add to.
+ * @param value The value to add.
+ */
+static inline void FingerprintAdd(uint32_t &fingerprint, uint64_t value)
+{
+	fingerprint ^= static_cast<uint32_t>(value ^ (value >> 32)) + 0x9E3779B9 + (fingerprint << 6) + (fingerprint >> 2);
+}
+
+/**
+ * Send the items of a pool that changed since they were last sent to this admin.
+ * When the budget for bulk updates runs out, the remaining changes are sent with the next update.
+ * @param type The type of the packets to send the records in.
+ * @param stream The state of the stream for this pool.
+ * @param pool_size The size of the pool.
+ * @param full Whether to forget what was sent before, and send everything again.
+ * @param fingerprint Function to get the fingerprint of the item at an index; 0 when there is no item.
+ * @param record_size Function to get the size of the record of the item at an index.
+ * @param write Function to write the record of the item at an index to a packet.
+ */
+template <typename Tfingerprint, typename Tsize, typename Twrite>
+void ServerNetworkAdminSocketHandler::SendTelemetryChanges(PacketAdminType type, AdminTelemetryStream &stream, size_t pool_size, bool full, Tfingerprint fingerprint, Tsize record_size, Twrite write)
+{
+	if (full) stream.fingerprints.clear();
+	if (stream.fingerprints.size() < pool_size) stream.fingerprints.resize(pool_size);
+
+	this->RefillTelemetryBudget();
+
+	size_t count = stream.fingerprints.size();
+	size_t start = stream.cursor < count ? stream.cursor : 0;
+	stream.cursor = 0;
+
+	std::unique_ptr<Packet> p;
+	for (size_t n = 0; n < count; n++) {
+		size_t index = (start + n) % count;
+		uint32_t current = index < pool_size ? fingerprint(index) : 0;
+		if (current == stream.fingerprints[index]) continue;
+
+		if (this->telemetry_budget <= 0) {
+			stream.cursor = index;
+			break;
+		}
+
+		size_t size = record_size(index, current != 0);
+		if (p != nullptr && !p->CanWriteToPacket(size)) this->SendPacket(std::move(p));
+		if (p == nullptr) p = std::make_unique<Packet>(this, type);
+
+		write(*p, index, current != 0);
+		stream.fingerprints[index] = current;
+		this->telemetry_budget -= size;
+	}
+
+	if (p != nullptr) this->SendPacket(std::move(p));
+}
+
+/**
+ * Send the vehicles that changed since they were last sent.
+ * @param full Whether to send all vehicles, instead of only the changed ones.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendVehicles(bool full)
+{
+	static constexpr size_t REMOVED_RECORD_SIZE = sizeof(uint32_t) + sizeof(bool);
+	static constexpr size_t RECORD_SIZE = REMOVED_RECORD_SIZE + 2 * sizeof(uint8_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint8_t);
+
+	/* Only the primary vehicles are of interest; the rest of the consist is summarised in them. */
+	auto get_primary = [](size_t index) -> const Vehicle * {
+		const Vehicle *v = Vehicle::GetIfValid(index);
+		return v != nullptr && v->IsPrimaryVehicle() ? v : nullptr;
+	};
+	auto get_cargo = [](const Vehicle *v) {
+		uint cargo = 0;
+		for (const Vehicle *u = v; u != nullptr; u = u->Next()) cargo += u->cargo.TotalCount();
+		return cargo;
+	};
+	auto get_flags = [](const Vehicle *v) {
+		uint8_t flags = 0;
+		if (v->vehstatus.Test(VehState::Stopped)) SetBit(flags, 0);
+		if (v->vehstatus.Test(VehState::Crashed)) SetBit(flags, 1);
+		if (v->IsChainInDepot()) SetBit(flags, 2);
+		return flags;
+	};
+
+	this->SendTelemetryChanges(PacketAdminType::ServerVehicles, this->vehicle_stream, Vehicle::GetPoolSize(), full,
+		[&](size_t index) -> uint32_t {
+			const Vehicle *v = get_primary(index);
+			if (v == nullptr) return 0;
+
+			uint32_t fingerprint = 0;
+			FingerprintAdd(fingerprint, v->owner.base() | v->unitnumber << 8 | static_cast<uint64_t>(get_flags(v)) << 24);
+			FingerprintAdd(fingerprint, v->tile.base() | static_cast<uint64_t>(v->GetDisplaySpeed()) << 32);
+			FingerprintAdd(fingerprint, get_cargo(v));
+			return std::max<uint32_t>(fingerprint, 1);
+		},
+		[&](size_t, bool exists) { return exists ? RECORD_SIZE : REMOVED_RECORD_SIZE; },
+		[&](Packet &p, size_t index, bool exists) {
+			p.Send_uint32(static_cast<uint32_t>(index));
+			p.Send_bool  (exists);
+			if (!exists) return;
+
+			const Vehicle *v = get_primary(index);
+			p.Send_uint8 (to_underlying(v->type));
+			p.Send_uint8 (v->owner.base());
+			p.Send_uint16(v->unitnumber);
+			p.Send_uint32(v->tile.base());
+			p.Send_uint16(ClampTo<uint16_t>(v->GetDisplaySpeed()));
+			p.Send_uint32(get_cargo(v));
+			p.Send_uint8 (get_flags(v));
+		});
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send the stations that changed since they were last sent.
+ * @param full Whether to send all stations, instead of only the changed ones.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendStations(bool full)
+{
+	static constexpr size_t REMOVED_RECORD_SIZE = sizeof(uint16_t) + sizeof(bool);
+	static constexpr size_t CARGO_RECORD_SIZE = 2 * sizeof(uint8_t) + sizeof(uint32_t);
+
+	this->SendTelemetryChanges(PacketAdminType::ServerStations, this->station_stream, Station::GetPoolSize(), full,
+		[](size_t index) -> uint32_t {
+			const Station *st = Station::GetIfValid(index);
+			if (st == nullptr) return 0;
+
+			uint32_t fingerprint = 0;
+			FingerprintAdd(fingerprint, st->owner.base());
+			for (CargoType cargo{}; cargo < NUM_CARGO; ++cargo) {
+				const GoodsEntry &ge = st->goods[cargo];
+				if (!ge.HasRating()) continue;
+				FingerprintAdd(fingerprint, cargo | ge.rating << 8 | static_cast<uint64_t>(ge.TotalCount()) << 32);
+			}
+			return std::max<uint32_t>(fingerprint, 1);
+		},
+		[](size_t index, bool exists) {
+			if (!exists) return REMOVED_RECORD_SIZE;
+
+			const Station *st = Station::Get(index);
+			size_t cargoes = std::ranges::count_if(st->goods, [](const GoodsEntry &ge) { return ge.HasRating(); });
+			return REMOVED_RECORD_SIZE + 2 * sizeof(uint8_t) + cargoes * CARGO_RECORD_SIZE;
+		},
+		[](Packet &p, size_t index, bool exists) {
+			p.Send_uint16(static_cast<uint16_t>(index));
+			p.Send_bool  (exists);
+			if (!exists) return;
+
+			const Station *st = Station::Get(index);
+			p.Send_uint8 (st->owner.base());
+			p.Send_uint8 (static_cast<uint8_t>(std::ranges::count_if(st->goods, [](const GoodsEntry &ge) { return ge.HasRating(); })));
+			for (CargoType cargo{}; cargo < NUM_CARGO; ++cargo) {
+				const GoodsEntry &ge = st->goods[cargo];
+				if (!ge.HasRating()) continue;
+				p.Send_uint8 (cargo);
+				p.Send_uint8 (ge.rating);
+				p.Send_uint32(ge.TotalCount());
+			}
+		});
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send the edges of the link graphs. Every call continues where the previous one ran out
+ * of budget for bulk updates, possibly halfway a link graph, until all link graphs have
+ * been sent once. The budget is checked before every packet, so a call never sends more
+ * than one packet beyond its budget.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendLinkGraphs()
+{
+	static constexpr size_t HEADER_SIZE = sizeof(uint16_t) + sizeof(uint8_t) + sizeof(bool);
+	static constexpr size_t EDGE_SIZE = 2 * sizeof(uint16_t) + 3 * sizeof(uint32_t);
+
+	this->RefillTelemetryBudget();
+
+	for (; this->link_graph_cursor < LinkGraph::GetPoolSize(); this->link_graph_cursor++, this->link_graph_node = 0, this->link_graph_edge = 0) {
+		const LinkGraph *lg = LinkGraph::GetIfValid(this->link_graph_cursor);
+		if (lg == nullptr) continue;
+
+		std::unique_ptr<Packet> p;
+		auto start_packet = [&]() {
+			if (this->telemetry_budget <= 0) return false;
+			p = std::make_unique<Packet>(this, PacketAdminType::ServerLinkGraph);
+			p->Send_uint16(lg->index.base());
+			p->Send_uint8 (lg->Cargo());
+			/* Tell the admin whether this is the start of the link graph, or a continuation of it. */
+			p->Send_bool  (this->link_graph_node == 0 && this->link_graph_edge == 0);
+			this->telemetry_budget -= HEADER_SIZE;
+			return true;
+		};
+
+		/* Always send the first packet, so the admin learns about link graphs without edges too. */
+		if (!start_packet()) return NETWORK_RECV_STATUS_OKAY;
+		for (; this->link_graph_node < lg->Size(); this->link_graph_node++, this->link_graph_edge = 0) {
+			const auto &edges = (*lg)[this->link_graph_node].edges;
+			for (; this->link_graph_edge < edges.size(); this->link_graph_edge++) {
+				if (!p->CanWriteToPacket(EDGE_SIZE)) {
+					this->SendPacket(std::move(p));
+					/* Out of budget; continue with this edge next time. */
+					if (!start_packet()) return NETWORK_RECV_STATUS_OKAY;
+				}
+
+				const LinkGraph::BaseEdge &edge = edges[this->link_graph_edge];
+				p->Send_uint16((*lg)[this->link_graph_node].station.base());
+				p->Send_uint16((*lg)[edge.dest_node].station.base());
+				p->Send_uint32(edge.capacity);
+				p->Send_uint32(edge.usage);
+				p->Send_uint32(edge.capacity == 0 ? 0 : edge.TravelTime());
+				this->telemetry_budget -= EDGE_SIZE;
+			}
+		}
+		this->SendPacket(std::move(p));
+	}
+
+	/* Everything has been sent; the next call starts a new round. */
+	this->link_graph_cursor = 0;
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send the time spent in the parts of the game loop.
+ * @param game_loop_only Whether to send only the last tick of the elements of the game loop, instead of a summary of the last day of all elements.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPerformance(bool game_loop_only)
+{
+	this->RefillTelemetryBudget();
+	if (this->telemetry_budget <= 0) return NETWORK_RECV_STATUS_OKAY;
+
+	int count = game_loop_only ? 1 : Ticks::DAY_TICKS;
+	PerformanceElement last = game_loop_only ? PFE_GL_LINKGRAPH : static_cast<PerformanceElement>(PFE_MAX - 1);
+
+	auto p = std::make_unique<Packet>(this, PacketAdminType::ServerPerformance);
+	p->Send_uint16(count);
+	p->Send_uint8 (last - PFE_FIRST + 1);
+	for (PerformanceElement elem = PFE_FIRST; elem <= last; elem++) {
+		PerformanceSummary summary = GetPerformanceSummary(elem, count);
+		p->Send_uint8 (elem);
+		p->Send_uint16(summary.count);
+		p->Send_uint32(ClampTo<uint32_t>(summary.average));
+		p->Send_uint32(ClampTo<uint32_t>(summary.maximum));
+	}
+	this->telemetry_budget -= p->Size();
+	this->SendPacket(std::move(p));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /***********
  * Receiving functions
  ************/
@@ -774,6 +1054,26 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::ReceiveAdminPoll(Packet &p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_VEHICLES:
+			/* The admin is requesting the changed vehicles, or all of them. */
+			this->SendVehicles(d1 == UINT32_MAX);
+			break;
+
+		case ADMIN_UPDATE_STATIONS:
+			/* The admin is requesting the changed stations, or all of them. */
+			this->SendStations(d1 == UINT32_MAX);
+			break;
+
+		case ADMIN_UPDATE_LINK_GRAPH:
+			/* The admin is requesting the link graphs. */
+			this->SendLinkGraphs();
+			break;
+
+		case ADMIN_UPDATE_PERFORMANCE:
+			/* The admin is requesting the performance measurements. */
+			this->SendPerformance(false);
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			Debug(net, 1, "[admin] Not supported poll {} ({}) from '{}' ({}).", type, d1, this->admin_name, this->admin_version);
@@ -1131,9 +1431,37 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						as->SendCompanyStats();
 						break;
 
+					case ADMIN_UPDATE_VEHICLES:
+						as->SendVehicles(false);
+						break;
+
+					case ADMIN_UPDATE_STATIONS:
+						as->SendStations(false);
+						break;
+
+					case ADMIN_UPDATE_LINK_GRAPH:
+						as->SendLinkGraphs();
+						break;
+
+					case ADMIN_UPDATE_PERFORMANCE:
+						as->SendPerformance(false);
+						break;
+
 					default: NOT_REACHED();
 				}
 			}
 		}
 	}
 }
+
+/**
+ * Send the updates that have to go out every tick to the admins that registered for them.
+ */
+void NetworkAdminTick()
+{
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (as->update_frequency[ADMIN_UPDATE_PERFORMANCE].Test(AdminUpdateFrequency::Automatic)) {
+			as->SendPerformance(true);
+		}
+	}
+}
@@ -13,10 +13,18 @@
 #include "network_internal.h"
 #include "core/tcp_listen.h"
 #include "core/tcp_admin.h"
+#include "../linkgraph/linkgraph_type.h"
 
 extern AdminID _redirect_console_to_admin;
 
 class ServerNetworkAdminSocketHandler;
+
+/** State of streaming the changes of the items of a pool to an admin. */
+struct AdminTelemetryStream {
+	std::vector<uint32_t> fingerprints{}; ///< Fingerprint of each item as it was last sent to the admin; 0 when nothing was sent.
+	size_t cursor = 0; ///< Index to continue at, when the previous update ran out of budget.
+};
+
 /** Pool type for admin connections. */
 using NetworkAdminSocketPool = Pool<ServerNetworkAdminSocketHandler, AdminID, 2, PoolType::NetworkAdmin>;
 /** Pool with all admin connections. */
@@ -43,11 +51,23 @@ protected:
 	NetworkRecvStatus SendPong(uint32_t d1);
 	NetworkRecvStatus SendAuthRequest();
 	NetworkRecvStatus SendEnableEncryption();
+
+	void RefillTelemetryBudget();
+	template <typename Tfingerprint, typename Tsize, typename Twrite>
+	void SendTelemetryChanges(PacketAdminType type, AdminTelemetryStream &stream, size_t pool_size, bool full, Tfingerprint fingerprint, Tsize record_size, Twrite write);
 public:
 	std::array<AdminUpdateFrequencies, ADMIN_UPDATE_END> update_frequency{}; ///< Admin requested update intervals.
 	std::chrono::steady_clock::time_point connect_time{}; ///< Time of connection.
 	NetworkAddress address{}; ///< Address of the admin.
 
+	int64_t telemetry_budget = 0; ///< Number of bytes of bulk updates that may still be sent; negative when the last update overshot it.
+	std::chrono::steady_clock::time_point telemetry_refill_time{}; ///< Last time the budget for bulk updates was refilled.
+	AdminTelemetryStream vehicle_stream{}; ///< Changes of the vehicles to send.
+	AdminTelemetryStream station_stream{}; ///< Changes of the stations to send.
+	size_t link_graph_cursor = 0; ///< Index of the next link graph to send.
+	NodeID link_graph_node = 0; ///< Node of the link graph at #link_graph_cursor to continue sending at.
+	size_t link_graph_edge = 0; ///< Edge of the node at #link_graph_node to continue sending at.
+
 	ServerNetworkAdminSocketHandler(AdminID index, SOCKET s);
 	~ServerNetworkAdminSocketHandler() override;
 
@@ -76,6 +96,10 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket &cp);
 	NetworkRecvStatus SendRconEnd(std::string_view command);
+	NetworkRecvStatus SendVehicles(bool full);
+	NetworkRecvStatus SendStations(bool full);
+	NetworkRecvStatus SendLinkGraphs();
+	NetworkRecvStatus SendPerformance(bool game_loop_only);
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
@@ -126,5 +150,6 @@ void NetworkServerSendAdminRcon(AdminID admin_index, TextColour colour_code, std
 void NetworkAdminConsole(std::string_view origin, std::string_view string);
 void NetworkAdminGameScript(std::string_view json);
 void NetworkAdminCmdLogging(const NetworkClientSocket *owner, const CommandPacket &cp);
+void NetworkAdminTick();
 
 #endif /* NETWORK_ADMIN_H */
@@ -15,6 +15,7 @@
 #include "../console_func.h"
 #include "../strings_func.h"
 #include "../window_func.h"
+#include "../window_gui.h"
 #include "../company_func.h"
 #include "../company_base.h"
 #include "../company_gui.h"
@@ -29,6 +30,7 @@
 #include "network_base.h"
 #include "network_client.h"
 #include "network_gamelist.h"
+#include "network_state_hash.h"
 #include "../core/backup_type.hpp"
 #include "../thread.h"
 #include "../social_integration.h"
@@ -113,6 +115,8 @@ ClientNetworkGameSocketHandler::~ClientNetworkGameSocketHandler()
 	ClientNetworkGameSocketHandler::my_client = nullptr;
 
 	delete this->GetInfo();
+
+	_network_catching_up = false;
 }
 
 NetworkRecvStatus ClientNetworkGameSocketHandler::CloseConnection(NetworkRecvStatus status)
@@ -216,6 +220,11 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 	if (my_client != nullptr) my_client->CheckConnection();
 }
 
+/** Whether the server wants us to report the hashes of our game state. */
+static bool _network_state_hash_requested = false;
+/** First frame of the epoch whose state hashes we need to report next. */
+static uint32_t _network_state_hash_next_frame = 0;
+
 /**
  * Actual game loop for the client.
  * @return Whether everything went okay, or not.
@@ -228,6 +237,8 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 
 	StateGameLoop();
 
+	if (_network_state_hash_requested) NetworkStateHashTick();
+
 	/* Check if we are in sync! */
 	if (_sync_frame != 0) {
 		if (_sync_frame == _frame_counter) {
@@ -251,6 +262,9 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 				SendAck();
 			}
 
+			/* We are in sync as far as the random state knows; let the server check the rest. */
+			if (_network_state_hash_requested) SendStateHash();
+
 			_sync_frame = 0;
 		} else if (_sync_frame < _frame_counter) {
 			Debug(net, 1, "Missed frame for sync-test: {} / {}", _sync_frame, _frame_counter);
@@ -262,6 +276,61 @@ void ClientNetworkGameSocketHandler::ClientError(NetworkRecvStatus res)
 }
 
 
+uint32_t _network_catch_up_frame; ///< The frame we started catching up with the server at.
+static std::chrono::steady_clock::time_point _network_catch_up_start; ///< The moment we started catching up with the server.
+
+/** Maximum time to run frames while catching up, before giving the video driver the chance to show the progress. */
+static constexpr std::chrono::milliseconds CATCH_UP_BATCH_TIME{100};
+
+/**
+ * Start running the frames the server ran while we were joining. While doing so,
+ * viewports, windows, sounds and news are not updated as they are of no use until
+ * we are at the frame the server is.
+ */
+static void NetworkStartCatchUp()
+{
+	_network_catching_up = true;
+	_network_catch_up_frame = _frame_counter;
+	_network_catch_up_start = std::chrono::steady_clock::now();
+
+	ShowJoinStatusWindow();
+}
+
+/**
+ * Game loop for the client while catching up with the server after joining. This
+ * runs frames as fast as possible, but returns every now and then, so the progress
+ * can be shown and new frames from the server can be received.
+ * @return Whether everything went okay, or not.
+ */
+/* static */ bool ClientNetworkGameSocketHandler::CatchUpLoop()
+{
+	auto end = std::chrono::steady_clock::now() + CATCH_UP_BATCH_TIME;
+	while (_frame_counter_max > _frame_counter && std::chrono::steady_clock::now() < end) {
+		if (!ClientNetworkGameSocketHandler::GameLoop()) return false;
+	}
+
+	/* We are done when the server accepted our first sync, and we ran all frames it allows us to run. */
+	if (_network_first_time || _frame_counter_max > _frame_counter) {
+		Window *w = FindWindowById(WC_NETWORK_STATUS_WINDOW, WN_NETWORK_STATUS_WINDOW_JOIN);
+		if (w != nullptr) w->SetDirty();
+		return true;
+	}
+
+	_network_catching_up = false;
+
+	auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _network_catch_up_start);
+	uint32_t frames = _frame_counter - _network_catch_up_frame;
+	uint64_t frames_per_second = frames * 1000ULL / std::max<int64_t>(duration.count(), 1);
+	Debug(net, 3, "Caught up {} frames in {} ms; {} frames per second", frames, duration.count(), frames_per_second);
+	IConsolePrint(CC_INFO, "Caught up with the server: {} ticks in {} ms, {} ticks per second.", frames, duration.count(), frames_per_second);
+
+	/* A new company is still being registered, otherwise joining is done. */
+	if (_network_join_status != NetworkJoinStatus::Registering) CloseWindowById(WC_NETWORK_STATUS_WINDOW, WN_NETWORK_STATUS_WINDOW_JOIN);
+	MarkWholeScreenDirty();
+	return true;
+}
+
+
 /** Our client's connection. */
 ClientNetworkGameSocketHandler * ClientNetworkGameSocketHandler::my_client = nullptr;
 
@@ -393,6 +462,34 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::SendAck()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the hashes of the game state over the epochs that completed since the last report.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ClientNetworkGameSocketHandler::SendStateHash()
+{
+	/* Only report the most recent epochs, so it always fits in a single packet. */
+	static constexpr size_t MAX_EPOCHS_PER_PACKET = 16;
+
+	std::vector<StateHashEpoch> epochs = NetworkGetStateHashEpochsSince(_network_state_hash_next_frame);
+	if (epochs.empty()) return NETWORK_RECV_STATUS_OKAY;
+	if (epochs.size() > MAX_EPOCHS_PER_PACKET) epochs.erase(epochs.begin(), epochs.end() - MAX_EPOCHS_PER_PACKET);
+
+	Debug(net, 9, "Client::SendStateHash(): epochs={}, first_frame={}", epochs.size(), epochs.front().frame);
+
+	auto p = std::make_unique<Packet>(my_client, PacketGameType::ClientStateHash);
+	p->Send_uint8(static_cast<uint8_t>(epochs.size()));
+	for (const StateHashEpoch &epoch : epochs) {
+		p->Send_uint32(epoch.frame);
+		p->Send_uint8(static_cast<uint8_t>(epoch.hashes.size()));
+		for (uint64_t hash : epoch.hashes) p->Send_uint64(hash);
+	}
+	my_client->SendPacket(std::move(p));
+
+	_network_state_hash_next_frame = epochs.back().frame + STATE_HASH_EPOCH_TICKS;
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a command to the server.
  * @param cp The command to send.
@@ -804,6 +901,9 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::ReceiveServerMapBegin(Packet &
 	this->savegame = std::make_shared<PacketReader>();
 
 	_frame_counter = _frame_counter_server = _frame_counter_max = p.Recv_uint32();
+	NetworkStateHashReset();
+	_network_state_hash_requested = false;
+	_network_state_hash_next_frame = 0;
 
 	Debug(net, 9, "Client::ReceiveServerMapBegin(): frame_counter={}", _frame_counter);
 
@@ -879,6 +979,8 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::ReceiveServerMapDone(Packet &)
 	/* Say we received the map and loaded it correctly! */
 	SendMapOk();
 
+	NetworkStartCatchUp();
+
 	/* As we skipped switch-mode, update the time we "switched". */
 	_game_session_stats.start_time = std::chrono::steady_clock::now();
 	_game_session_stats.savegame_size = std::nullopt;
@@ -952,6 +1054,7 @@ NetworkRecvStatus ClientNetworkGameSocketHandler::ReceiveServerSync(Packet &p)
 #ifdef NETWORK_SEND_DOUBLE_SEED
 	_sync_seed_2 = p.Recv_uint32();
 #endif
+	_network_state_hash_requested = p.Recv_bool();
 
 	Debug(net, 9, "Client::ReceiveServerSync(): sync_frame={}, sync_seed_1={}", _sync_frame, _sync_seed_1);
 
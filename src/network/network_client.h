@@ -85,6 +85,7 @@ public:
 	static NetworkRecvStatus SendError(NetworkErrorCode errorno);
 	static NetworkRecvStatus SendQuit();
 	static NetworkRecvStatus SendAck();
+	static NetworkRecvStatus SendStateHash();
 
 	static NetworkRecvStatus SendAuthResponse();
 
@@ -98,6 +99,7 @@ public:
 	static void Send();
 	static bool Receive();
 	static bool GameLoop();
+	static bool CatchUpLoop();
 };
 
 /** Helper to make the code look somewhat nicer. */
@@ -244,9 +244,9 @@ void NetworkSendCommand(Commands cmd, StringID err_message, CommandCallback *cal
  */
 void NetworkSyncCommandQueue(NetworkClientSocket *cs)
 {
-	for (auto &p : _local_execution_queue) {
-		CommandPacket &c = cs->outgoing_queue.emplace_back(p);
+	for (CommandPacket c : _local_execution_queue) {
 		c.callback = nullptr;
+		cs->outgoing_queue.push_back(NetworkEncodeServerCommand(c));
 	}
 }
 
@@ -303,13 +303,25 @@ static void DistributeCommandPacket(CommandPacket &cp, const NetworkClientSocket
 	CommandCallback *callback = cp.callback;
 	cp.frame = _frame_counter_max + 1;
 
+	/* The command is the same for everyone but the owner, so it only needs to be encoded once. */
+	std::optional<EncodedCommand> encoded;
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
 		if (cs->status >= NetworkClientSocket::STATUS_MAP) {
 			/* Callbacks are only send back to the client who sent them in the
 			 *  first place. This filters that out. */
-			cp.callback = (cs != owner) ? nullptr : callback;
-			cp.my_cmd = (cs == owner);
-			cs->outgoing_queue.push_back(cp);
+			if (cs == owner) {
+				cp.callback = callback;
+				cp.my_cmd = true;
+				cs->outgoing_queue.push_back(NetworkEncodeServerCommand(cp));
+				continue;
+			}
+
+			if (!encoded.has_value()) {
+				cp.callback = nullptr;
+				cp.my_cmd = false;
+				encoded = NetworkEncodeServerCommand(cp);
+			}
+			cs->outgoing_queue.push_back(*encoded);
 		}
 	}
 
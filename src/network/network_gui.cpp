@@ -2129,6 +2129,11 @@ struct NetworkJoinStatusWindow : Window {
 			}
 
 			case WID_NJS_PROGRESS_TEXT:
+				if (_network_catching_up) {
+					DrawStringMultiLine(r, GetString(STR_NETWORK_CONNECTING_CATCHING_UP, _frame_counter - _network_catch_up_frame, _frame_counter_max - _network_catch_up_frame), TC_FROMSTRING, SA_CENTER);
+					break;
+				}
+
 				switch (_network_join_status) {
 					case NetworkJoinStatus::Waiting:
 						DrawStringMultiLine(r, GetString(STR_NETWORK_CONNECTING_WAITING, _network_join_waiting), TC_FROMSTRING, SA_CENTER);
@@ -2169,6 +2174,7 @@ struct NetworkJoinStatusWindow : Window {
 				uint64_t max_digits = GetParamMaxDigits(8);
 				size = maxdim(size, GetStringBoundingBox(GetString(STR_NETWORK_CONNECTING_DOWNLOADING_1, max_digits, max_digits)));
 				size = maxdim(size, GetStringBoundingBox(GetString(STR_NETWORK_CONNECTING_DOWNLOADING_1, max_digits, max_digits)));
+				size = maxdim(size, GetStringBoundingBox(GetString(STR_NETWORK_CONNECTING_CATCHING_UP, max_digits, max_digits)));
 				break;
 			}
 		}
@@ -72,6 +72,7 @@ extern NetworkJoinStatus _network_join_status;
 extern uint8_t _network_join_waiting;
 extern uint32_t _network_join_bytes;
 extern uint32_t _network_join_bytes_total;
+extern uint32_t _network_catch_up_frame;
 extern ConnectionType _network_server_connection_type;
 extern std::string _network_server_invite_code;
 
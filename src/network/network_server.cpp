@@ -14,6 +14,7 @@
 #include "network_server.h"
 #include "network_udp.h"
 #include "network_base.h"
+#include "network_state_hash.h"
 #include "../console_func.h"
 #include "../company_base.h"
 #include "../command_func.h"
@@ -35,7 +36,6 @@
 #include "../timer/timer_game_economy.h"
 #include "../timer/timer_game_realtime.h"
 #include <mutex>
-#include <condition_variable>
 
 #include "table/strings.h"
 
@@ -63,53 +63,63 @@ static NetworkAuthenticationDefaultAuthorizedKeyHandler _authorized_key_handler{
 static NetworkAuthenticationDefaultAuthorizedKeyHandler _rcon_authorized_key_handler{_settings_client.network.rcon_authorized_keys}; ///< Provides the authorized key validation for rcon.
 
 
-/** Writing a savegame directly to a number of packets. */
+/**
+ * Writing a savegame directly to a buffer that is shared by all clients that
+ * start downloading the map in the same frame. The savegame is only made once,
+ * after which every client gets its own packets from the shared buffer.
+ */
 struct PacketWriter : SaveFilter {
-	ServerNetworkGameSocketHandler *cs; ///< Socket we are associated with.
-	std::unique_ptr<Packet> current; ///< The packet we're currently writing to.
-	size_t total_size;                  ///< Total size of the compressed savegame.
-	std::deque<std::unique_ptr<Packet>> packets; ///< Packet queue of the savegame; send these "slowly" to the client. Cannot be a std::queue as we want to push the map size packet in front of the data packets.
-	std::mutex mutex;                   ///< Mutex for making threaded saving safe.
-	std::condition_variable exit_sig;   ///< Signal for threaded destruction of this packet writer.
+	const uint32_t frame;                     ///< The frame the savegame was made in.
+	uint clients = 0;                         ///< Number of clients still downloading this savegame.
+	bool finished = false;                    ///< Whether the savegame has been completely written.
+	size_t total_size = 0;                    ///< Total size of the compressed savegame.
+	std::deque<std::vector<uint8_t>> chunks;  ///< The written parts of the compressed savegame.
+	std::mutex mutex;                         ///< Mutex for making threaded saving safe.
 
 	/**
 	 * Create the packet writer.
-	 * @param cs The socket handler we're making the packets for.
+	 * @param frame The frame the savegame is made in.
 	 */
-	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(nullptr), cs(cs), total_size(0)
+	PacketWriter(uint32_t frame) : SaveFilter(nullptr), frame(frame)
 	{
 	}
 
-	/** Make sure everything is cleaned up under lock. */
-	~PacketWriter() override
+	/**
+	 * Check whether a client that starts downloading the map now can use this savegame.
+	 * @return True iff the savegame was made in this frame and is not being aborted.
+	 */
+	bool CanShare()
 	{
-		std::unique_lock<std::mutex> lock(this->mutex);
-
-		while (this->cs != nullptr) this->exit_sig.wait(lock);
+		std::lock_guard<std::mutex> lock(this->mutex);
+		return this->frame == _frame_counter && this->clients != 0;
+	}
 
-		/* This must all wait until the Destroy function is called. */
+	/**
+	 * Register a client as downloader of this savegame.
+	 * @param cs The client that starts downloading the map.
+	 */
+	void Attach(ServerNetworkGameSocketHandler *cs)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
 
-		this->packets.clear();
-		this->current = nullptr;
+		this->clients++;
+		cs->savegame_chunk = 0;
+		cs->savegame_offset = 0;
+		cs->savegame_bytes_sent = 0;
+		cs->savegame_size_sent = false;
 	}
 
 	/**
-	 * Begin the destruction of this packet writer. It can happen in two ways:
-	 * in the first case the client disconnected while saving the map. In this
-	 * case the saving has not finished and killed this PacketWriter. In that
-	 * case we simply set cs to nullptr, triggering the appending to fail due to
-	 * the connection problem and eventually triggering the destructor. In the
-	 * second case the destructor is already called, and it is waiting for our
-	 * signal which we will send. Only then the packets will be removed by the
-	 * destructor.
+	 * Unregister a client from this savegame. When the last client is gone
+	 * while the saving has not finished yet, the saving is cancelled as the
+	 * next Write will fail due to the connection problem.
 	 */
-	void Destroy()
+	void Detach()
 	{
 		std::unique_lock<std::mutex> lock(this->mutex);
 
-		this->cs = nullptr;
-
-		this->exit_sig.notify_all();
+		assert(this->clients != 0);
+		if (--this->clients != 0) return;
 		lock.unlock();
 
 		/* Make sure the saving is completely cancelled. Yes,
@@ -119,47 +129,60 @@ struct PacketWriter : SaveFilter {
 	}
 
 	/**
-	 * Transfer all packets from here to the network's queue while holding
+	 * Transfer all packets that can be made from the written part of the
+	 * savegame to the network's queue of the given client while holding
 	 * the lock on our mutex.
+	 * @param cs The client to transfer the packets to.
 	 * @return True iff the last packet of the map has been sent.
 	 */
-	bool TransferToNetworkQueue()
+	bool TransferToNetworkQueue(ServerNetworkGameSocketHandler *cs)
 	{
-		/* Unsafe check for the queue being empty or not. */
-		if (this->packets.empty()) return false;
-
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		while (!this->packets.empty()) {
-			bool last_packet = this->packets.front()->GetPacketType() == to_underlying(PacketGameType::ServerMapDone);
-			this->cs->SendPacket(std::move(this->packets.front()));
-			this->packets.pop_front();
+		/* Fast-track the size to the client. */
+		if (this->finished && !cs->savegame_size_sent) {
+			auto p = std::make_unique<Packet>(cs, PacketGameType::ServerMapSize);
+			p->Send_uint32((uint32_t)this->total_size);
+			cs->SendPacket(std::move(p));
+			cs->savegame_size_sent = true;
+		}
+
+		while (cs->savegame_bytes_sent < this->total_size) {
+			auto p = std::make_unique<Packet>(cs, PacketGameType::ServerMapData, TCP_MTU);
+
+			/* Only send partially filled packets for the last bit of the savegame. */
+			if (!this->finished && this->total_size - cs->savegame_bytes_sent < TCP_MTU - p->Size()) break;
 
-			if (last_packet) return true;
+			while (p->CanWriteToPacket(1) && cs->savegame_bytes_sent < this->total_size) {
+				std::span<const uint8_t> to_write = std::span(this->chunks[cs->savegame_chunk]).subspan(cs->savegame_offset);
+				size_t written = to_write.size() - p->Send_bytes(to_write).size();
+
+				cs->savegame_bytes_sent += written;
+				cs->savegame_offset += written;
+				if (cs->savegame_offset == this->chunks[cs->savegame_chunk].size()) {
+					cs->savegame_chunk++;
+					cs->savegame_offset = 0;
+				}
+			}
+
+			cs->SendPacket(std::move(p));
 		}
 
-		return false;
+		if (!this->finished || cs->savegame_bytes_sent != this->total_size) return false;
+
+		/* Add a packet stating that this is the end to the queue. */
+		cs->SendPacket(std::make_unique<Packet>(cs, PacketGameType::ServerMapDone));
+		return true;
 	}
 
 	void Write(uint8_t *buf, size_t size) override
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
-		if (this->current == nullptr) this->current = std::make_unique<Packet>(this->cs, PacketGameType::ServerMapData, TCP_MTU);
-
-		std::span<const uint8_t> to_write(buf, size);
-		while (!to_write.empty()) {
-			to_write = this->current->Send_bytes(to_write);
-
-			if (!this->current->CanWriteToPacket(1)) {
-				this->packets.push_back(std::move(this->current));
-				if (!to_write.empty()) this->current = std::make_unique<Packet>(this->cs, PacketGameType::ServerMapData, TCP_MTU);
-			}
-		}
+		/* We want to abort the saving when all sockets are closed. */
+		if (this->clients == 0) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
 
+		this->chunks.emplace_back(buf, buf + size);
 		this->total_size += size;
 	}
 
@@ -167,22 +190,16 @@ struct PacketWriter : SaveFilter {
 	{
 		std::lock_guard<std::mutex> lock(this->mutex);
 
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == nullptr) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+		/* We want to abort the saving when all sockets are closed. */
+		if (this->clients == 0) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
 
-		/* Make sure the last packet is flushed. */
-		if (this->current != nullptr) this->packets.push_back(std::move(this->current));
-
-		/* Add a packet stating that this is the end to the queue. */
-		this->packets.push_back(std::make_unique<Packet>(this->cs, PacketGameType::ServerMapDone));
-
-		/* Fast-track the size to the client. */
-		auto p = std::make_unique<Packet>(this->cs, PacketGameType::ServerMapSize);
-		p->Send_uint32((uint32_t)this->total_size);
-		this->packets.push_front(std::move(p));
+		this->finished = true;
 	}
 };
 
+/** The savegame that is currently, or was last, being sent to joining clients. */
+static std::weak_ptr<PacketWriter> _network_map_savegame;
+
 
 /**
  * Create a new socket for the server side of the game connection.
@@ -214,7 +231,7 @@ ServerNetworkGameSocketHandler::~ServerNetworkGameSocketHandler()
 	OrderBackup::ResetUser(this->client_id);
 
 	if (this->savegame != nullptr) {
-		this->savegame->Destroy();
+		this->savegame->Detach();
 		this->savegame = nullptr;
 	}
 
@@ -263,8 +280,8 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::CloseConnection(NetworkRecvSta
 	/* If we were transferring a map to this client, stop the savegame creation
 	 * process and queue the next client to receive the map. */
 	if (this->status == STATUS_MAP) {
-		/* Ensure the saving of the game is stopped too. */
-		this->savegame->Destroy();
+		/* Ensure the saving of the game is stopped too, unless other clients still need it. */
+		this->savegame->Detach();
 		this->savegame = nullptr;
 
 		this->CheckNextClientToSendMap(this);
@@ -540,35 +557,24 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendWait()
 }
 
 /**
- * Find the next candidate for joining, and start the joining process for that client.
+ * Start the joining process for all clients that are waiting for the map, when nobody is downloading it anymore.
+ * All these clients start in the same frame, so they share a single savegame.
  * @param ignore_cs A client to ignore while searching.
  */
 void ServerNetworkGameSocketHandler::CheckNextClientToSendMap(NetworkClientSocket *ignore_cs)
 {
 	Debug(net, 9, "client[{}] CheckNextClientToSendMap()", this->client_id);
 
-	/* Find the best candidate for joining, i.e. the first joiner. */
-	NetworkClientSocket *best = nullptr;
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-		if (ignore_cs == new_cs) continue;
-
-		if (new_cs->status == STATUS_MAP_WAIT) {
-			if (best == nullptr || best->GetInfo()->join_date > new_cs->GetInfo()->join_date || (best->GetInfo()->join_date == new_cs->GetInfo()->join_date && best->client_id > new_cs->client_id)) {
-				best = new_cs;
-			}
-		}
+		if (ignore_cs != new_cs && new_cs->status == STATUS_MAP) return;
 	}
 
-	/* Is there someone else to join? */
-	if (best != nullptr) {
-		/* Let the first start joining. */
-		best->status = STATUS_AUTHORIZED;
-		best->SendMap();
+	/* Let everyone that is waiting start joining. */
+	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
+		if (ignore_cs == new_cs || new_cs->status != STATUS_MAP_WAIT) continue;
 
-		/* And update the rest. */
-		for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
-			if (new_cs->status == STATUS_MAP_WAIT) new_cs->SendWait();
-		}
+		new_cs->status = STATUS_AUTHORIZED;
+		new_cs->SendMap();
 	}
 }
 
@@ -586,8 +592,15 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 	if (this->status == STATUS_AUTHORIZED) {
 		Debug(net, 9, "client[{}] SendMap(): first_packet", this->client_id);
 
-		WaitTillSaved();
-		this->savegame = std::make_shared<PacketWriter>(this);
+		/* Reuse the savegame of other clients that started joining in this frame. */
+		this->savegame = _network_map_savegame.lock();
+		bool new_savegame = this->savegame == nullptr || !this->savegame->CanShare();
+		if (new_savegame) {
+			WaitTillSaved();
+			this->savegame = std::make_shared<PacketWriter>(_frame_counter);
+			_network_map_savegame = this->savegame;
+		}
+		this->savegame->Attach(this);
 
 		/* Now send the _frame_counter and how many packets are coming */
 		auto p = std::make_unique<Packet>(this, PacketGameType::ServerMapBegin);
@@ -602,16 +615,16 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		this->last_frame_server = _frame_counter;
 
 		/* Make a dump of the current game */
-		if (SaveWithFilter(this->savegame, true) != SL_OK) UserError("network savedump failed");
+		if (new_savegame && SaveWithFilter(this->savegame, true) != SL_OK) UserError("network savedump failed");
 	}
 
 	if (this->status == STATUS_MAP) {
-		bool last_packet = this->savegame->TransferToNetworkQueue();
+		bool last_packet = this->savegame->TransferToNetworkQueue(this);
 		if (last_packet) {
 			Debug(net, 9, "client[{}] SendMap(): last_packet", this->client_id);
 
 			/* Done reading, make sure saving is done as well */
-			this->savegame->Destroy();
+			this->savegame->Detach();
 			this->savegame = nullptr;
 
 			/* Set the status to DONE_MAP, no we will wait for the client
@@ -643,20 +656,62 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendJoin(ClientID client_id)
 }
 
 /**
- * Tell the client that they may run to a particular frame.
- * @return The new state the network.
+ * Encode the part of a frame packet that is the same for all clients.
+ * @return The encoded frame.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
+static PacketPayload EncodeFrame()
 {
-	auto p = std::make_unique<Packet>(this, PacketGameType::ServerFrame);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_frame_counter_max);
+	Packet p(nullptr, PacketGameType::ServerFrame);
+	p.Send_uint32(_frame_counter);
+	p.Send_uint32(_frame_counter_max);
 #ifdef ENABLE_NETWORK_SYNC_EVERY_FRAME
-	p->Send_uint32(_sync_seed_1);
+	p.Send_uint32(_sync_seed_1);
 #ifdef NETWORK_SEND_DOUBLE_SEED
-	p->Send_uint32(_sync_seed_2);
+	p.Send_uint32(_sync_seed_2);
 #endif
 #endif
+	return p.ToPayload();
+}
+
+/**
+ * Encode a sync packet, which is the same for all clients.
+ * @return The encoded sync.
+ */
+static PacketPayload EncodeSync()
+{
+	Packet p(nullptr, PacketGameType::ServerSync);
+	p.Send_uint32(_frame_counter);
+	p.Send_uint32(_sync_seed_1);
+#ifdef NETWORK_SEND_DOUBLE_SEED
+	p.Send_uint32(_sync_seed_2);
+#endif
+	p.Send_bool(_settings_client.network.sync_state_hash);
+	return p.ToPayload();
+}
+
+/**
+ * Encode a command for sending it to clients.
+ * @param cp The command to encode.
+ * @return The encoded command.
+ */
+EncodedCommand NetworkEncodeServerCommand(const CommandPacket &cp)
+{
+	Packet p(nullptr, PacketGameType::ServerCommand);
+	NetworkGameSocketHandler::SendCommand(p, cp);
+	p.Send_uint32(cp.frame);
+	p.Send_bool  (cp.my_cmd);
+	return {cp.cmd, p.ToPayload()};
+}
+
+/**
+ * Tell the client that they may run to a particular frame.
+ * @param payload The frame encoded by EncodeFrame.
+ * @return The new state the network.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame(const PacketPayload &payload)
+{
+	auto p = std::make_unique<Packet>(this, PacketGameType::ServerFrame);
+	p->Send_payload(payload);
 
 	/* If token equals 0, we need to make a new token and send that. */
 	if (this->last_token == 0) {
@@ -670,38 +725,30 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendFrame()
 
 /**
  * Request the client to sync.
+ * @param payload The sync encoded by EncodeSync.
  * @return The new state the network.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync()
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendSync(const PacketPayload &payload)
 {
 	Debug(net, 9, "client[{}] SendSync(), frame_counter={}, sync_seed_1={}", this->client_id, _frame_counter, _sync_seed_1);
 
 	auto p = std::make_unique<Packet>(this, PacketGameType::ServerSync);
-	p->Send_uint32(_frame_counter);
-	p->Send_uint32(_sync_seed_1);
-
-#ifdef NETWORK_SEND_DOUBLE_SEED
-	p->Send_uint32(_sync_seed_2);
-#endif
+	p->Send_payload(payload);
 	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
 /**
  * Send a command to the client to execute.
- * @param cp The command to send.
+ * @param command The command encoded by NetworkEncodeServerCommand.
  * @return The new state the network.
  */
-NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacket &cp)
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const EncodedCommand &command)
 {
-	Debug(net, 9, "client[{}] SendCommand(): cmd={}", this->client_id, cp.cmd);
+	Debug(net, 9, "client[{}] SendCommand(): cmd={}", this->client_id, command.cmd);
 
 	auto p = std::make_unique<Packet>(this, PacketGameType::ServerCommand);
-
-	this->NetworkGameSocketHandler::SendCommand(*p, cp);
-	p->Send_uint32(cp.frame);
-	p->Send_bool  (cp.my_cmd);
-
+	p->Send_payload(command.payload);
 	this->SendPacket(std::move(p));
 	return NETWORK_RECV_STATUS_OKAY;
 }
@@ -1048,6 +1095,10 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientGetMap(Packet &)
 
 	Debug(net, 9, "client[{}] ReceiveClientGetMap()", this->client_id);
 
+	/* Join the download of others when their savegame was made in this frame. */
+	std::shared_ptr<PacketWriter> savegame = _network_map_savegame.lock();
+	if (savegame != nullptr && savegame->CanShare()) return this->SendMap();
+
 	/* Check if someone else is receiving the map */
 	for (NetworkClientSocket *new_cs : NetworkClientSocket::Iterate()) {
 		if (new_cs->status == STATUS_MAP) {
@@ -1080,8 +1131,8 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientMapOk(Packet &)
 		Debug(net, 9, "client[{}] status = PRE_ACTIVE", this->client_id);
 		this->status = STATUS_PRE_ACTIVE;
 		NetworkHandleCommandQueue(this);
-		this->SendFrame();
-		this->SendSync();
+		this->SendFrame(EncodeFrame());
+		this->SendSync(EncodeSync());
 
 		/* This is the frame the client receives
 		 *  we need it later on to make sure the client is not too slow */
@@ -1294,6 +1345,44 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientAck(Packet &p)
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+NetworkRecvStatus ServerNetworkGameSocketHandler::ReceiveClientStateHash(Packet &p)
+{
+	if (this->status < STATUS_PRE_ACTIVE) {
+		/* Illegal call, return error and ignore the packet */
+		return this->SendError(NetworkErrorCode::NotExpected);
+	}
+
+	uint8_t count = p.Recv_uint8();
+	for (uint8_t i = 0; i < count; i++) {
+		StateHashEpoch epoch;
+		epoch.frame = p.Recv_uint32();
+		uint8_t subsystems = p.Recv_uint8();
+		if (subsystems != epoch.hashes.size()) return this->SendError(NetworkErrorCode::IllegalPacket);
+		for (uint64_t &hash : epoch.hashes) hash = p.Recv_uint64();
+
+		/* Only the first divergence is interesting; everything after it is a consequence. */
+		if (this->state_hash_diverged) continue;
+
+		/* Epochs we have not hashed, or already forgot about, can not be compared. */
+		const StateHashEpoch *ours = NetworkGetStateHashEpoch(epoch.frame);
+		if (ours == nullptr || ours->hashes == epoch.hashes) continue;
+
+		std::string subsystem_names;
+		for (size_t j = 0; j < epoch.hashes.size(); j++) {
+			if (ours->hashes[j] == epoch.hashes[j]) continue;
+			if (!subsystem_names.empty()) subsystem_names += ", ";
+			subsystem_names += GetStateHashSubsystemName(static_cast<StateHashSubsystem>(j));
+		}
+
+		uint32_t last_frame = epoch.frame + STATE_HASH_EPOCH_TICKS - 1;
+		Debug(desync, 0, "State of client #{} diverged in frames {} to {}: {}", this->client_id, epoch.frame, last_frame, subsystem_names);
+		IConsolePrint(CC_WARNING, "State of client #{} ({}) diverged from the server in frames {} to {}: {}.", this->client_id, this->GetInfo()->client_name, epoch.frame, last_frame, subsystem_names);
+		this->state_hash_diverged = true;
+	}
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 
 /**
  * Send an actual chat message.
@@ -1729,7 +1818,7 @@ bool NetworkServerChangeClientName(ClientID client_id, const std::string &new_na
  */
 static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 {
-	for (auto &cp : cs->outgoing_queue) cs->SendCommand(cp);
+	for (auto &command : cs->outgoing_queue) cs->SendCommand(command);
 	cs->outgoing_queue.clear();
 }
 
@@ -1750,6 +1839,12 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* The frame and sync are the same for all clients, so only encode them once. */
+	PacketPayload frame = send_frame ? EncodeFrame() : nullptr;
+#ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
+	PacketPayload sync = send_sync ? EncodeSync() : nullptr;
+#endif
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -1860,14 +1955,15 @@ void NetworkServer_Tick(bool send_frame)
 			NetworkHandleCommandQueue(cs);
 
 			/* Send an updated _frame_counter_max to the client */
-			if (send_frame) cs->SendFrame();
+			if (send_frame) cs->SendFrame(frame);
 
 #ifndef ENABLE_NETWORK_SYNC_EVERY_FRAME
 			/* Send a sync-check packet */
-			if (send_sync) cs->SendSync();
+			if (send_sync) cs->SendSync(sync);
 #endif
 		}
 	}
+	NetworkAdminTick();
 }
 
 /** Helper function to restart the map. */
@@ -14,6 +14,13 @@
 #include "core/tcp_listen.h"
 
 class ServerNetworkGameSocketHandler;
+
+/** A command encoded once, to be sent to one or more clients. */
+struct EncodedCommand {
+	Commands cmd; ///< The command, for debugging.
+	PacketPayload payload; ///< The encoded command packet.
+};
+
 /** Make the code look slightly nicer/simpler. */
 typedef ServerNetworkGameSocketHandler NetworkClientSocket;
 /** Pool with all client sockets. */
@@ -41,6 +48,7 @@ protected:
 	NetworkRecvStatus ReceiveClientRemoteConsoleCommand(Packet &p) override;
 	NetworkRecvStatus ReceiveClientNewGRFsChecked(Packet &p) override;
 	NetworkRecvStatus ReceiveClientMove(Packet &p) override;
+	NetworkRecvStatus ReceiveClientStateHash(Packet &p) override;
 
 	NetworkRecvStatus SendGameInfo();
 	NetworkRecvStatus SendNewGRFCheck();
@@ -67,11 +75,16 @@ public:
 	uint8_t lag_test = 0; ///< Byte used for lag-testing the client
 	uint8_t last_token = 0; ///< The last random token we did send to verify the client is listening
 	uint32_t last_token_frame = 0; ///< The last frame we received the right token
+	bool state_hash_diverged = false; ///< Whether the state hashes of this client have been found to diverge from ours.
 	ClientStatus status = STATUS_INACTIVE; ///< Status of this client
-	CommandQueue outgoing_queue{}; ///< The command-queue awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
+	std::vector<EncodedCommand> outgoing_queue{}; ///< The encoded commands awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
 	size_t receive_limit = 0; ///< Amount of bytes that we can receive at this moment
 
-	std::shared_ptr<struct PacketWriter> savegame = nullptr; ///< Writer used to write the savegame.
+	std::shared_ptr<struct PacketWriter> savegame = nullptr; ///< Writer used to write the savegame; shared with the other clients joining in the same frame.
+	size_t savegame_chunk = 0; ///< Index of the chunk of the savegame to send next.
+	size_t savegame_offset = 0; ///< Offset within the chunk of the savegame to send next.
+	size_t savegame_bytes_sent = 0; ///< Number of bytes of the savegame that have been queued for sending.
+	bool savegame_size_sent = false; ///< Whether the size of the savegame has been queued for sending.
 	NetworkAddress client_address{}; ///< IP-address of the client (so they can be banned)
 
 	ServerNetworkGameSocketHandler(ClientPoolID index, SOCKET s);
@@ -97,9 +110,9 @@ public:
 	NetworkRecvStatus SendChat(NetworkAction action, ClientID client_id, bool self_send, std::string_view msg, int64_t data);
 	NetworkRecvStatus SendExternalChat(std::string_view source, TextColour colour, std::string_view user, std::string_view msg);
 	NetworkRecvStatus SendJoin(ClientID client_id);
-	NetworkRecvStatus SendFrame();
-	NetworkRecvStatus SendSync();
-	NetworkRecvStatus SendCommand(const CommandPacket &cp);
+	NetworkRecvStatus SendFrame(const PacketPayload &payload);
+	NetworkRecvStatus SendSync(const PacketPayload &payload);
+	NetworkRecvStatus SendCommand(const EncodedCommand &command);
 	NetworkRecvStatus SendConfigUpdate();
 
 	static void Send();
@@ -126,6 +139,7 @@ public:
 	static ServerNetworkGameSocketHandler *GetByClientID(ClientID client_id);
 };
 
+EncodedCommand NetworkEncodeServerCommand(const CommandPacket &cp);
 void NetworkServer_Tick(bool send_frame);
 void ChangeNetworkRestartTime(bool reset);
 
@@ -0,0 +1,298 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/**
+ * @file network_state_hash.cpp Per-subsystem hashes of the game state, to find where a desync started.
+ *
+ * The tiles, in chunks of 1 << STATE_HASH_TILE_CHUNK_BITS, and the vehicles each have
+ * their own hash, and the hash of the subsystem combines them. When a tile or vehicle
+ * changes it is marked, and at the end of the epoch the hashes of the marked chunks and
+ * vehicles are replaced. So the cost follows the number of changes, not the size of the
+ * map. Not every write to the map marks its tile, so in addition a small slice of the
+ * tiles and vehicles is hashed each tick, and in STATE_HASH_SWEEP_TICKS all of them.
+ * The hashes are only reported once that has been done since hashing started, so a
+ * client that just joined reports the same hashes as the server.
+ *
+ * The stations are hashed, a slice each tick, and the companies, at the end, over
+ * every epoch. The hashes of the last few epochs are kept, so the server can compare
+ * them with the ones the clients report.
+ */
+
+#include "../stdafx.h"
+#include "network_state_hash.h"
+#include "network_internal.h"
+#include "../map_func.h"
+#include "../vehicle_base.h"
+#include "../station_base.h"
+#include "../company_base.h"
+
+#include "../safeguards.h"
+
+/** Number of completed epochs to remember; enough to cover clients lagging behind. */
+static constexpr size_t STATE_HASH_EPOCH_HISTORY = 32;
+/** Number of ticks in which all tiles and vehicles are hashed once, whether or not they were marked as changed. */
+static constexpr uint32_t STATE_HASH_SWEEP_TICKS = 16 * STATE_HASH_EPOCH_TICKS;
+
+/** The hashes of a vehicle. */
+struct VehicleStateHash {
+	uint64_t vehicle = 0; ///< Hash of the position, movement and ownership.
+	uint64_t cargo = 0; ///< Hash of the amount of cargo.
+};
+
+std::vector<bool> _state_hash_changed_chunks; ///< Chunks of tiles that changed since their hash was updated.
+std::vector<bool> _state_hash_changed_vehicles; ///< Vehicles that changed since their hash was updated.
+
+static std::vector<uint64_t> _state_hash_chunks; ///< Hash of each chunk of tiles.
+static std::vector<VehicleStateHash> _state_hash_vehicles; ///< Hashes of each vehicle slot; 0 when it is empty.
+static uint64_t _state_hash_map = 0; ///< Combined hash of all chunks of tiles.
+static uint64_t _state_hash_vehicle = 0; ///< Combined hash of all vehicles.
+static uint64_t _state_hash_vehicle_cargo = 0; ///< Combined hash of the cargo in all vehicles.
+
+static std::array<StateHashEpoch, STATE_HASH_EPOCH_HISTORY> _state_hash_epochs; ///< Ring of the completed epochs, indexed by epoch number.
+static StateHashEpoch _state_hash_current; ///< The epoch that is being hashed.
+static bool _state_hash_current_valid = false; ///< Whether the current epoch has been hashed since its first frame.
+static bool _state_hash_running = false; ///< Whether the game state has been hashed since the hashes were reset.
+static uint32_t _state_hash_first_frame = 0; ///< The frame since which every frame has been hashed.
+static uint32_t _state_hash_last_frame = 0; ///< The frame that was hashed last.
+
+/**
+ * Mix a value into a hash.
+ * @param hash The hash to add to.
+ * @param value The value to add.
+ */
+static inline void HashAdd(uint64_t &hash, uint64_t value)
+{
+	hash ^= value + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+}
+
+/**
+ * Replace the hash of a chunk of tiles.
+ * @param chunk The chunk.
+ */
+static void UpdateChunkHash(size_t chunk)
+{
+	uint64_t hash = chunk;
+	const uint begin = static_cast<uint>(chunk << STATE_HASH_TILE_CHUNK_BITS);
+	for (uint i = begin; i < begin + (1U << STATE_HASH_TILE_CHUNK_BITS); i++) {
+		Tile tile(i);
+		HashAdd(hash, tile.type() | tile.height() << 8 | tile.m1() << 16 | static_cast<uint64_t>(tile.m2()) << 24 | static_cast<uint64_t>(tile.m3()) << 40 | static_cast<uint64_t>(tile.m4()) << 48);
+		HashAdd(hash, tile.m5() | tile.m6() << 8 | tile.m7() << 16 | static_cast<uint64_t>(tile.m8()) << 24);
+	}
+
+	_state_hash_map ^= _state_hash_chunks[chunk] ^ hash;
+	_state_hash_chunks[chunk] = hash;
+	_state_hash_changed_chunks[chunk] = false;
+}
+
+/**
+ * Replace the hashes of a vehicle slot.
+ * @param index The index of the slot in the vehicle pool.
+ */
+static void UpdateVehicleHash(size_t index)
+{
+	VehicleStateHash hash;
+	const Vehicle *v = Vehicle::GetIfValid(index);
+	if (v != nullptr) {
+		hash.vehicle = index;
+		HashAdd(hash.vehicle, v->tile.base());
+		HashAdd(hash.vehicle, static_cast<uint32_t>(v->x_pos) | static_cast<uint64_t>(static_cast<uint32_t>(v->y_pos)) << 32);
+		HashAdd(hash.vehicle, static_cast<uint32_t>(v->z_pos) | static_cast<uint64_t>(v->direction) << 32 | static_cast<uint64_t>(v->progress) << 40 | static_cast<uint64_t>(v->owner.base()) << 48);
+		HashAdd(hash.vehicle, v->cur_speed);
+
+		hash.cargo = index;
+		HashAdd(hash.cargo, v->cargo.TotalCount());
+	}
+
+	VehicleStateHash &old = _state_hash_vehicles[index];
+	_state_hash_vehicle ^= old.vehicle ^ hash.vehicle;
+	_state_hash_vehicle_cargo ^= old.cargo ^ hash.cargo;
+	old = hash;
+	if (index < _state_hash_changed_vehicles.size()) _state_hash_changed_vehicles[index] = false;
+}
+
+/**
+ * Make room for the hashes of all chunks of tiles and vehicle slots.
+ * @return True if the map changed size, so all hashes start over.
+ */
+static bool AllocateStateHashes()
+{
+	if (Vehicle::GetPoolSize() > _state_hash_vehicles.size()) _state_hash_vehicles.resize(Vehicle::GetPoolSize());
+
+	const size_t chunks = Map::Size() >> STATE_HASH_TILE_CHUNK_BITS;
+	if (_state_hash_chunks.size() == chunks) return false;
+
+	_state_hash_chunks.assign(chunks, 0);
+	_state_hash_changed_chunks.assign(chunks, false);
+	_state_hash_map = 0;
+	return true;
+}
+
+/**
+ * Hash the slice of the tiles and vehicles for a frame, whether or not they were marked as changed.
+ * @param slot The slot within the sweep.
+ */
+static void HashSweepSlice(uint32_t slot)
+{
+	const size_t chunks = _state_hash_chunks.size();
+	for (size_t chunk = chunks * slot / STATE_HASH_SWEEP_TICKS; chunk < chunks * (slot + 1) / STATE_HASH_SWEEP_TICKS; chunk++) {
+		UpdateChunkHash(chunk);
+	}
+	for (size_t i = slot; i < _state_hash_vehicles.size(); i += STATE_HASH_SWEEP_TICKS) {
+		UpdateVehicleHash(i);
+	}
+}
+
+/** Update the hashes of the tiles and vehicles that were marked as changed. */
+static void HashChanges()
+{
+	for (size_t chunk = 0; chunk < _state_hash_changed_chunks.size(); chunk++) {
+		if (_state_hash_changed_chunks[chunk]) UpdateChunkHash(chunk);
+	}
+	for (size_t i = 0; i < _state_hash_changed_vehicles.size(); i++) {
+		if (!_state_hash_changed_vehicles[i]) continue;
+		if (i >= _state_hash_vehicles.size()) _state_hash_vehicles.resize(i + 1);
+		UpdateVehicleHash(i);
+	}
+}
+
+/**
+ * Hash a slice of the stations.
+ * @param hashes The hashes to add to.
+ * @param slot The slot within the epoch.
+ */
+static void HashStationSlice(StateHashes &hashes, uint32_t slot)
+{
+	uint64_t &hash = hashes[to_underlying(StateHashSubsystem::Stations)];
+	uint64_t &cargo = hashes[to_underlying(StateHashSubsystem::Cargo)];
+	for (size_t i = slot; i < Station::GetPoolSize(); i += STATE_HASH_EPOCH_TICKS) {
+		const Station *st = Station::GetIfValid(i);
+		if (st == nullptr) continue;
+
+		HashAdd(hash, i);
+		HashAdd(hash, st->xy.base() | static_cast<uint64_t>(st->owner.base()) << 32);
+
+		HashAdd(cargo, i);
+		for (const GoodsEntry &ge : st->goods) {
+			HashAdd(hash, ge.rating | ge.time_since_pickup << 8);
+			HashAdd(cargo, ge.TotalCount());
+		}
+	}
+}
+
+/**
+ * Hash the finances of all companies.
+ * @param hash The hash to add to.
+ */
+static void HashCompanies(uint64_t &hash)
+{
+	for (const Company *c : Company::Iterate()) {
+		HashAdd(hash, c->index.base());
+		HashAdd(hash, static_cast<int64_t>(c->money));
+		HashAdd(hash, static_cast<int64_t>(c->current_loan));
+	}
+}
+
+/**
+ * Hash the changes and the slice of the game state for the current frame.
+ * Must be called after every StateGameLoop, on the server as well as on the clients.
+ */
+void NetworkStateHashTick()
+{
+	uint32_t frame = _frame_counter;
+	/* After loading a game, or when hashing was not done for a while, the hashes have to be swept again. */
+	if (AllocateStateHashes() || !_state_hash_running || frame != _state_hash_last_frame + 1) {
+		_state_hash_running = true;
+		_state_hash_first_frame = frame;
+		_state_hash_current_valid = false;
+		/* Marks from before are not made by the other clients, so they must not make these hashes any fresher. */
+		_state_hash_changed_chunks.assign(_state_hash_changed_chunks.size(), false);
+		_state_hash_changed_vehicles.assign(_state_hash_changed_vehicles.size(), false);
+	}
+	_state_hash_last_frame = frame;
+
+	HashSweepSlice(frame % STATE_HASH_SWEEP_TICKS);
+
+	uint32_t slot = frame % STATE_HASH_EPOCH_TICKS;
+	if (slot == 0) {
+		_state_hash_current = {};
+		_state_hash_current.frame = frame;
+		_state_hash_current_valid = true;
+	}
+	if (!_state_hash_current_valid) return;
+
+	StateHashes &hashes = _state_hash_current.hashes;
+	HashStationSlice(hashes, slot);
+
+	if (slot == STATE_HASH_EPOCH_TICKS - 1) {
+		/* There are only a few companies, so hash all of them once, at the end of the epoch. */
+		HashCompanies(hashes[to_underlying(StateHashSubsystem::Companies)]);
+		HashChanges();
+		hashes[to_underlying(StateHashSubsystem::Map)] = _state_hash_map;
+		hashes[to_underlying(StateHashSubsystem::Vehicles)] = _state_hash_vehicle;
+		HashAdd(hashes[to_underlying(StateHashSubsystem::Cargo)], _state_hash_vehicle_cargo);
+		_state_hash_current_valid = false;
+
+		/* Until all tiles and vehicles have been swept, the hashes of changes from before hashing started are missing. */
+		if (frame - _state_hash_first_frame + 1 < STATE_HASH_SWEEP_TICKS) return;
+		_state_hash_epochs[(frame / STATE_HASH_EPOCH_TICKS) % STATE_HASH_EPOCH_HISTORY] = _state_hash_current;
+	}
+}
+
+/** Forget all hashes, e.g. after a (new) game got loaded. */
+void NetworkStateHashReset()
+{
+	_state_hash_epochs = {};
+	_state_hash_current_valid = false;
+	_state_hash_running = false;
+	_state_hash_last_frame = 0;
+}
+
+/**
+ * Get the hashes of a completed epoch.
+ * @param frame The first frame of the epoch.
+ * @return The epoch, or \c nullptr when it is unknown or has been forgotten.
+ */
+const StateHashEpoch *NetworkGetStateHashEpoch(uint32_t frame)
+{
+	/* Frame 0 never gets hashed, so it marks an unused entry. */
+	if (frame == 0 || frame % STATE_HASH_EPOCH_TICKS != 0) return nullptr;
+
+	const StateHashEpoch &epoch = _state_hash_epochs[(frame / STATE_HASH_EPOCH_TICKS) % STATE_HASH_EPOCH_HISTORY];
+	return epoch.frame == frame ? &epoch : nullptr;
+}
+
+/**
+ * Get all remembered completed epochs starting at or after the given frame.
+ * @param frame The first frame of interest.
+ * @return The epochs, in order of their frame.
+ */
+std::vector<StateHashEpoch> NetworkGetStateHashEpochsSince(uint32_t frame)
+{
+	std::vector<StateHashEpoch> epochs;
+	for (const StateHashEpoch &epoch : _state_hash_epochs) {
+		if (epoch.frame != 0 && epoch.frame >= frame) epochs.push_back(epoch);
+	}
+	std::sort(epochs.begin(), epochs.end(), [](const StateHashEpoch &a, const StateHashEpoch &b) { return a.frame < b.frame; });
+	return epochs;
+}
+
+/**
+ * Get the name of a subsystem, for in the desync reports.
+ * @param subsystem The subsystem.
+ * @return The name.
+ */
+std::string_view GetStateHashSubsystemName(StateHashSubsystem subsystem)
+{
+	switch (subsystem) {
+		case StateHashSubsystem::Map: return "map";
+		case StateHashSubsystem::Vehicles: return "vehicles";
+		case StateHashSubsystem::Stations: return "stations";
+		case StateHashSubsystem::Companies: return "companies";
+		case StateHashSubsystem::Cargo: return "cargo";
+		default: NOT_REACHED();
+	}
+}
@@ -0,0 +1,73 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file network_state_hash.h Per-subsystem hashes of the game state, to find where a desync started. */
+
+#ifndef NETWORK_STATE_HASH_H
+#define NETWORK_STATE_HASH_H
+
+#include "../core/enum_type.hpp"
+#include "../tile_type.h"
+
+/** The parts of the game state that are hashed separately. */
+enum class StateHashSubsystem : uint8_t {
+	Map, ///< The contents of all tiles.
+	Vehicles, ///< Position, movement and ownership of vehicles.
+	Stations, ///< Location, ownership and ratings of stations.
+	Companies, ///< Finances of the companies.
+	Cargo, ///< Amounts of cargo in vehicles and at stations.
+	End, ///< End marker.
+};
+
+/** The hashes of all subsystems over one epoch. */
+using StateHashes = std::array<uint64_t, to_underlying(StateHashSubsystem::End)>;
+
+/**
+ * Number of ticks in one epoch. The hashes are compared at the end of every epoch,
+ * so a mismatch can be pinned down to an epoch but not to a tick.
+ */
+static constexpr uint32_t STATE_HASH_EPOCH_TICKS = 64;
+
+/** Number of tiles that share a hash, as a power of 2. */
+static constexpr uint STATE_HASH_TILE_CHUNK_BITS = 8;
+
+/** The hashes of a completed epoch. */
+struct StateHashEpoch {
+	uint32_t frame = 0; ///< First frame of the epoch.
+	StateHashes hashes{}; ///< The hashes of each subsystem.
+};
+
+extern std::vector<bool> _state_hash_changed_chunks;
+extern std::vector<bool> _state_hash_changed_vehicles;
+
+/**
+ * Mark that the contents of a tile changed, so its hash gets updated at the end of the epoch.
+ * @param tile The tile.
+ */
+inline void StateHashMarkTileChanged(TileIndex tile)
+{
+	const size_t chunk = tile.base() >> STATE_HASH_TILE_CHUNK_BITS;
+	if (chunk < _state_hash_changed_chunks.size()) _state_hash_changed_chunks[chunk] = true;
+}
+
+/**
+ * Mark that a vehicle moved or was removed, so its hash gets updated at the end of the epoch.
+ * @param index The index of the vehicle in its pool.
+ */
+inline void StateHashMarkVehicleChanged(size_t index)
+{
+	if (index >= _state_hash_changed_vehicles.size()) _state_hash_changed_vehicles.resize(index + 1);
+	_state_hash_changed_vehicles[index] = true;
+}
+
+void NetworkStateHashTick();
+void NetworkStateHashReset();
+const StateHashEpoch *NetworkGetStateHashEpoch(uint32_t frame);
+std::vector<StateHashEpoch> NetworkGetStateHashEpochsSince(uint32_t frame);
+std::string_view GetStateHashSubsystemName(StateHashSubsystem subsystem);
+
+#endif /* NETWORK_STATE_HASH_H */
@@ -1190,6 +1190,19 @@ bool UsesWagonOverride(const Vehicle *v)
 	return Train::From(v)->tcache.cached_override != nullptr;
 }
 
+/**
+ * Check whether a NewGRF can answer callbacks for vehicles of an engine.
+ * Without sprite groups of its own or wagon overrides, there is nothing
+ * to resolve a callback with, so it fails whatever the state of the vehicle.
+ * @param engine The engine type.
+ * @return False iff every callback of the engine fails.
+ */
+static bool EngineHasCallbacks(EngineID engine)
+{
+	const Engine *e = Engine::Get(engine);
+	return !e->grf_prop.spritegroups.empty() || !e->overrides.empty();
+}
+
 /**
  * Evaluate a newgrf callback for vehicles
  * @param callback The callback to evaluate
@@ -1202,6 +1215,9 @@ bool UsesWagonOverride(const Vehicle *v)
  */
 uint16_t GetVehicleCallback(CallbackID callback, uint32_t param1, uint32_t param2, EngineID engine, const Vehicle *v, std::span<int32_t> regs100)
 {
+	/* Most of the time this is callback 36 for a vehicle without any NewGRF; skip setting up the resolver. */
+	if (!EngineHasCallbacks(engine)) return CALLBACK_FAILED;
+
 	VehicleResolverObject object(engine, v, VehicleResolverObject::WO_UNCACHED, false, callback, param1, param2);
 	return object.ResolveCallback(regs100);
 }
@@ -34,6 +34,7 @@
 #include "zoom_func.h"
 #include "news_cmd.h"
 #include "news_func.h"
+#include "network/network.h"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
 #include "timer/timer_game_calendar.h"
@@ -920,6 +921,9 @@ void AddNewsItem(EncodedString &&headline, NewsType type, NewsStyle style, NewsF
 {
 	if (_game_mode == GM_MENU) return;
 
+	/* News of the frames run while catching up with the server is old news by the time it could be shown. */
+	if (_network_catching_up) return;
+
 	/* Create new news item node */
 	_news.emplace_front(std::move(headline), type, style, flags, ref1, ref2, std::move(data), advice_type);
 
@@ -428,8 +428,7 @@ public:
 		this->Initialize(v);
 	}
 
-	/** Destructor. Invalidates OrderList for re-usage by the pool. */
-	~OrderList() {}
+	~OrderList();
 
 	void Initialize(Vehicle *v);
 
@@ -26,6 +26,7 @@
 #include "cheat_type.h"
 #include "order_cmd.h"
 #include "train_cmd.h"
+#include "linkgraph/refresh.h"
 
 #include "table/strings.h"
 
@@ -284,6 +285,13 @@ void OrderList::RecalculateTimetableDuration()
 	}
 }
 
+/** Destructor. Invalidates OrderList for re-usage by the pool. */
+OrderList::~OrderList()
+{
+	/* An order list that reuses the index must not replay the link refresh walks of this one. */
+	LinkRefresher::InvalidateMemo(this->index);
+}
+
 /**
  * Free a complete order chain.
  * @param keep_orderlist If this is true only delete the orders, otherwise also delete the OrderList.
@@ -20,10 +20,17 @@
 #include "../debug.h"
 #include "../3rdparty/fmt/ranges.h"
 #include "../core/convertible_through_base.hpp"
+#include "../thread.h"
+#include "../timer/timer.h"
+#include "../timer/timer_game_tick.h"
+#include <atomic>
+#include <condition_variable>
 #include "../safeguards.h"
 
 using WaterRegionTraversabilityBits = uint16_t;
 constexpr WaterRegionPatchLabel FIRST_REGION_LABEL{1};
+static constexpr uint WATER_REGION_UPDATES_PER_TICK = 64; ///< Maximum number of invalid water regions to update every tick, when they are not updated in bulk.
+static constexpr uint MAX_WATER_REGION_WORKERS = 8; ///< Maximum number of threads updating water regions, including the game thread.
 
 static_assert(sizeof(WaterRegionTraversabilityBits) * 8 == WATER_REGION_EDGE_LENGTH);
 static_assert(sizeof(WaterRegionPatchLabel) == sizeof(uint8_t)); // Important for the hash calculation.
@@ -126,7 +133,6 @@ public:
 	 */
 	void ForceUpdate()
 	{
-		Debug(map, 3, "Updating water region ({},{})", GetWaterRegionX(this->tile_area.tile), GetWaterRegionY(this->tile_area.tile));
 		this->data.has_cross_region_aqueducts = false;
 
 		/* Acquire a tile patch label array if this region does not already have one */
@@ -143,7 +149,7 @@ public:
 		/* Perform connected component labeling. This uses a flooding algorithm that expands until no
 		 * additional tiles can be added. Only tiles inside the water region are considered. */
 		for (const TileIndex start_tile : this->tile_area) {
-			static std::vector<TileIndex> tiles_to_check;
+			thread_local std::vector<TileIndex> tiles_to_check;
 			tiles_to_check.clear();
 			tiles_to_check.push_back(start_tile);
 
@@ -223,6 +229,10 @@ public:
 
 TypedIndexContainer<std::vector<WaterRegionData>, WaterRegionIndex> _water_region_data;
 TypedIndexContainer<std::vector<bool>, WaterRegionIndex> _is_water_region_valid;
+static uint _invalid_water_regions = 0; ///< Number of water regions that are not valid.
+static uint _next_water_region_update = 0; ///< Index of the water region to continue looking for invalid ones at.
+static WaterRegionStatistics _water_region_statistics; ///< Counts of the water region updates.
+static uint32_t _water_layout_version = 0; ///< Changes whenever a water region is invalidated or docking tiles change.
 
 static TileIndex GetTileIndexFromLocalCoordinate(int region_x, int region_y, int local_x, int local_y)
 {
@@ -248,8 +258,11 @@ static WaterRegion GetUpdatedWaterRegion(uint16_t region_x, uint16_t region_y)
 	const WaterRegionIndex index = GetWaterRegionIndex(region_x, region_y);
 	WaterRegion water_region(region_x, region_y, _water_region_data[index]);
 	if (!_is_water_region_valid[index]) {
+		Debug(map, 3, "Updating water region ({},{})", region_x, region_y);
 		water_region.ForceUpdate();
 		_is_water_region_valid[index] = true;
+		_invalid_water_regions--;
+		_water_region_statistics.lazy_updates++;
 	}
 	return water_region;
 }
@@ -318,9 +331,12 @@ void InvalidateWaterRegion(TileIndex tile)
 {
 	if (!IsValidTile(tile)) return;
 
+	_water_layout_version++;
+
 	auto invalidate_region = [](TileIndex tile) {
 		const WaterRegionIndex water_region_index = GetWaterRegionIndex(tile);
 		if (!_is_water_region_valid[water_region_index]) Debug(map, 3, "Invalidated water region ({},{})", GetWaterRegionX(tile), GetWaterRegionY(tile));
+		if (_is_water_region_valid[water_region_index]) _invalid_water_regions++;
 		_is_water_region_valid[water_region_index] = false;
 	};
 
@@ -336,6 +352,26 @@ void InvalidateWaterRegion(TileIndex tile)
 	}
 }
 
+/**
+ * Notify that docking tiles were added or removed. That does not change the
+ * water regions, but it does change where ships can reach their destination.
+ */
+void NotifyDockingTilesChange()
+{
+	_water_layout_version++;
+}
+
+/**
+ * Get the version of the layout of the water. It changes whenever a water
+ * region is invalidated or docking tiles change, so anything derived from the
+ * water regions and docking tiles is still valid as long as it does not change.
+ * @return The version of the layout.
+ */
+uint32_t GetWaterLayoutVersion()
+{
+	return _water_layout_version;
+}
+
 /**
  * Calls the provided callback function for all water region patches
  * accessible from one particular side of the starting patch.
@@ -424,11 +460,201 @@ void AllocateWaterRegions()
 
 	_is_water_region_valid.clear();
 	_is_water_region_valid.resize(number_of_regions, false);
+	_invalid_water_regions = number_of_regions;
+	_next_water_region_update = 0;
+	_water_region_statistics = {};
+	_water_layout_version++;
 
 	Debug(map, 2, "Allocating {} x {} water regions", GetWaterRegionMapSizeX(), GetWaterRegionMapSizeY());
 	assert(_is_water_region_valid.size() == _water_region_data.size());
 }
 
+/**
+ * Update some of the water regions that are not valid. Each region only
+ * depends on the tiles within it, so the result is the same as updating it
+ * when a ship first needs it.
+ * @param max_regions The maximum number of regions to update.
+ */
+void UpdateInvalidWaterRegions(uint max_regions)
+{
+	const uint number_of_regions = static_cast<uint>(_water_region_data.size());
+	uint updated = 0;
+	for (uint checked = 0; checked < number_of_regions && updated < max_regions && _invalid_water_regions > 0; checked++) {
+		const uint index = _next_water_region_update;
+		_next_water_region_update = (index + 1) % number_of_regions;
+		if (_is_water_region_valid[WaterRegionIndex{index}]) continue;
+
+		Debug(map, 3, "Updating water region ({},{})", index % GetWaterRegionMapSizeX(), index / GetWaterRegionMapSizeX());
+		WaterRegion(index % GetWaterRegionMapSizeX(), index / GetWaterRegionMapSizeX(), _water_region_data[WaterRegionIndex{index}]).ForceUpdate();
+		_is_water_region_valid[WaterRegionIndex{index}] = true;
+		_invalid_water_regions--;
+		updated++;
+	}
+	_water_region_statistics.tick_updates += updated;
+}
+
+/**
+ * Threads that update water regions in bulk. They are started on first use
+ * and live until the game exits. The threads only update the data of the
+ * regions handed to them, one thread per region; everything else, including
+ * debug output, is left to the game thread.
+ */
+struct WaterRegionWorkers {
+	std::mutex lock; ///< Lock for everything below.
+	std::condition_variable work_available; ///< Signalled when regions have been handed out, or the threads have to exit.
+	std::condition_variable work_done; ///< Signalled when a thread stopped updating regions.
+	std::vector<std::thread> threads; ///< The worker threads.
+	bool started = false; ///< Whether an attempt to start the threads has been made.
+	bool exit = false; ///< Whether the threads have to exit.
+
+	std::span<const WaterRegionIndex> regions; ///< The regions to update.
+	std::atomic<size_t> next = 0; ///< The next region to update.
+	uint busy = 0; ///< Number of threads updating regions.
+
+	/**
+	 * Start the threads, if not done yet. Must be called with the lock held.
+	 * @return True if there are threads to help the game thread.
+	 */
+	bool StartThreads()
+	{
+		if (!this->started) {
+			this->started = true;
+			uint workers = std::min(std::thread::hardware_concurrency(), MAX_WATER_REGION_WORKERS);
+			for (uint i = 1; i < workers; i++) {
+				std::thread thread;
+				if (!StartNewThread(&thread, "ottd:waterreg", [](WaterRegionWorkers *workers) { workers->Run(); }, this)) break;
+				this->threads.push_back(std::move(thread));
+			}
+		}
+		return !this->threads.empty();
+	}
+
+	/**
+	 * Check whether there are regions left that nobody started on yet.
+	 * @return True if there are regions left.
+	 */
+	bool HasRegionsLeft() const { return this->next.load(std::memory_order_relaxed) < this->regions.size(); }
+
+	/** Update regions until none are left. */
+	void Work()
+	{
+		for (size_t i = this->next.fetch_add(1, std::memory_order_relaxed); i < this->regions.size(); i = this->next.fetch_add(1, std::memory_order_relaxed)) {
+			const uint index = this->regions[i].base();
+			WaterRegion(index % GetWaterRegionMapSizeX(), index / GetWaterRegionMapSizeX(), _water_region_data[this->regions[i]]).ForceUpdate();
+		}
+	}
+
+	/** Main loop of the worker threads. */
+	void Run()
+	{
+		std::unique_lock<std::mutex> lk(this->lock);
+		for (;;) {
+			this->work_available.wait(lk, [&]() { return this->exit || this->HasRegionsLeft(); });
+			if (this->exit) return;
+
+			this->busy++;
+			lk.unlock();
+			this->Work();
+			lk.lock();
+			if (--this->busy == 0) this->work_done.notify_all();
+		}
+	}
+
+	/**
+	 * Update water regions, spread over the game thread and the worker threads.
+	 * Returns when all of them are updated.
+	 * @param regions The regions to update.
+	 */
+	void Update(std::span<const WaterRegionIndex> regions)
+	{
+		std::unique_lock<std::mutex> lk(this->lock);
+		const bool threaded = this->StartThreads();
+		this->regions = regions;
+		this->next = 0;
+		lk.unlock();
+		if (threaded) this->work_available.notify_all();
+
+		this->Work();
+
+		/* Wait for the threads to finish the regions they took, before the list goes out of scope. */
+		lk.lock();
+		this->work_done.wait(lk, [&]() { return this->busy == 0; });
+		this->regions = {};
+		this->next = 0;
+	}
+
+	~WaterRegionWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lk(this->lock);
+			this->exit = true;
+		}
+		this->work_available.notify_all();
+		for (std::thread &thread : this->threads) thread.join();
+	}
+};
+
+/**
+ * Get the threads that update water regions in bulk; they are joined when the game exits.
+ * @return The threads.
+ */
+static WaterRegionWorkers &GetWaterRegionWorkers()
+{
+	static WaterRegionWorkers workers;
+	return workers;
+}
+
+/**
+ * Update all water regions that are not valid, spread over several threads.
+ * Every region only depends on the tiles within it and is updated by a
+ * single thread, so the result is the same as updating them one by one on
+ * the game thread, whichever thread updates which region.
+ */
+void UpdateAllInvalidWaterRegions()
+{
+	if (_invalid_water_regions == 0) return;
+
+	std::vector<WaterRegionIndex> regions;
+	regions.reserve(_invalid_water_regions);
+	for (uint index = 0; index < _water_region_data.size(); index++) {
+		if (!_is_water_region_valid[WaterRegionIndex{index}]) regions.emplace_back(index);
+	}
+
+	GetWaterRegionWorkers().Update(regions);
+
+	for (WaterRegionIndex index : regions) _is_water_region_valid[index] = true;
+	_invalid_water_regions = 0;
+	_water_region_statistics.bulk_updates += regions.size();
+	Debug(map, 3, "Updated {} water regions in bulk", regions.size());
+}
+
+/**
+ * Keep the water regions up to date, so ships find them valid instead of
+ * updating them on demand. When many regions were invalidated at once, for
+ * example by terraforming a large area, they are all updated in bulk. A few
+ * invalid regions are updated on the game thread instead, as handing them
+ * to the threads would cost more than it saves.
+ */
+static const IntervalTimer<TimerGameTick> _update_water_regions({TimerGameTick::Priority::None, 1}, [](auto) {
+	if (_invalid_water_regions > WATER_REGION_UPDATES_PER_TICK) {
+		UpdateAllInvalidWaterRegions();
+	} else {
+		UpdateInvalidWaterRegions(WATER_REGION_UPDATES_PER_TICK);
+	}
+});
+
+/**
+ * Get the counts of the water region updates since the regions were allocated.
+ * @return The statistics.
+ */
+WaterRegionStatistics GetWaterRegionStatistics()
+{
+	WaterRegionStatistics statistics = _water_region_statistics;
+	statistics.regions = static_cast<uint>(_water_region_data.size());
+	statistics.invalid_regions = _invalid_water_regions;
+	return statistics;
+}
+
 void PrintWaterRegionDebugInfo(TileIndex tile)
 {
 	GetUpdatedWaterRegion(tile).PrintDebugInfo();
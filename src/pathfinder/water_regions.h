@@ -54,11 +54,26 @@ WaterRegionDesc GetWaterRegionInfo(TileIndex tile);
 WaterRegionPatchDesc GetWaterRegionPatchInfo(TileIndex tile);
 
 void InvalidateWaterRegion(TileIndex tile);
+void NotifyDockingTilesChange();
+uint32_t GetWaterLayoutVersion();
 
 using VisitWaterRegionPatchCallback = std::function<void(const WaterRegionPatchDesc &)>;
 void VisitWaterRegionPatchNeighbours(const WaterRegionPatchDesc &water_region_patch, VisitWaterRegionPatchCallback &callback);
 
 void AllocateWaterRegions();
+void UpdateInvalidWaterRegions(uint max_regions);
+void UpdateAllInvalidWaterRegions();
+
+/** Counts of the water region updates. */
+struct WaterRegionStatistics {
+	uint regions = 0; ///< Number of water regions.
+	uint invalid_regions = 0; ///< Number of water regions that need to be updated.
+	uint64_t lazy_updates = 0; ///< Number of water regions updated on demand while searching a path.
+	uint64_t tick_updates = 0; ///< Number of water regions updated a few every tick, before ships needed them.
+	uint64_t bulk_updates = 0; ///< Number of water regions updated in bulk, after loading a game or invalidating many of them.
+};
+
+WaterRegionStatistics GetWaterRegionStatistics();
 
 void PrintWaterRegionDebugInfo(TileIndex tile);
 
@@ -16,6 +16,11 @@
 /**
  * Hash table based node list multi-container class.
  *  Implements open list, closed list and priority queue for A-star pathfinder.
+ *
+ *  The nodes and the containers live in a storage that is kept per thread
+ *  after the search, so the next search of the same kind reuses the memory
+ *  instead of allocating it again. Only when a search nests in another one
+ *  of the same kind, it gets a storage of its own.
  */
 template <class Titem, int Thash_bits_open, int Thash_bits_closed>
 class NodeList {
@@ -24,26 +29,112 @@ public:
 	using Key = typename Titem::Key;
 
 protected:
-	std::deque<Titem> items; ///< Storage of the nodes.
-	HashTable<Titem, Thash_bits_open> open_nodes; ///< Hash table of pointers to open nodes.
-	HashTable<Titem, Thash_bits_closed> closed_nodes; ///< Hash table of pointers to closed nodes.
-	CBinaryHeapT<Titem> open_queue; ///< Priority queue of pointers to open nodes.
+	static constexpr size_t CHUNK_SIZE = 256; ///< Number of nodes allocated at once.
+	static constexpr size_t MAX_KEPT_NODES = 32768; ///< Maximum number of nodes to keep the memory for after a search, also when the search is unlimited.
+	static constexpr size_t INITIAL_QUEUE_CAPACITY = 2048; ///< Initial capacity of the priority queue.
+
+	/** Storage of the nodes and the containers of a node list. */
+	struct Storage {
+		std::vector<std::unique_ptr<Titem[]>> chunks; ///< Storage of the nodes, in chunks so they never move.
+		size_t count = 0; ///< Number of nodes in use.
+		HashTable<Titem, Thash_bits_open> open_nodes; ///< Hash table of pointers to open nodes.
+		HashTable<Titem, Thash_bits_closed> closed_nodes; ///< Hash table of pointers to closed nodes.
+		CBinaryHeapT<Titem> open_queue{INITIAL_QUEUE_CAPACITY}; ///< Priority queue of pointers to open nodes.
+		bool in_use = false; ///< Whether a node list is using this storage.
+
+		/**
+		 * Get a node.
+		 * @param index The index of the node.
+		 * @return The node.
+		 */
+		inline Titem &At(size_t index)
+		{
+			return this->chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+		}
+
+		/** @copydoc At */
+		inline const Titem &At(size_t index) const
+		{
+			return this->chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+		}
+
+		/**
+		 * Forget all nodes, but keep the memory for the next search.
+		 * @param max_nodes Number of nodes to keep the memory for, or 0 when the search was unlimited.
+		 */
+		void Reset(size_t max_nodes)
+		{
+			this->open_nodes.Clear();
+			this->closed_nodes.Clear();
+			this->count = 0;
+
+			/* Do not keep the memory of an exceptionally large search around. */
+			size_t keep_nodes = max_nodes == 0 ? MAX_KEPT_NODES : std::min(max_nodes, MAX_KEPT_NODES);
+			size_t keep_chunks = keep_nodes / CHUNK_SIZE + 1;
+			if (this->chunks.size() > keep_chunks) {
+				this->chunks.resize(keep_chunks);
+				this->open_queue = CBinaryHeapT<Titem>{INITIAL_QUEUE_CAPACITY};
+			} else {
+				this->open_queue.Clear();
+			}
+		}
+	};
+
+	/**
+	 * Get the storage kept for the searches of this thread.
+	 * @return The storage.
+	 */
+	static Storage &GetThreadStorage()
+	{
+		static thread_local Storage storage;
+		return storage;
+	}
+
+	std::unique_ptr<Storage> own_storage; ///< Storage of a nested search, when the one of the thread is in use.
+	Storage *storage; ///< The storage in use.
+	size_t max_nodes = 0; ///< Number of nodes the storage keeps the memory for after the search.
 	Titem *new_node; ///< New node under construction.
 
 public:
 	/** default constructor */
-	NodeList() : open_queue(2048)
+	NodeList()
 	{
+		this->storage = &GetThreadStorage();
+		if (this->storage->in_use) {
+			this->own_storage = std::make_unique<Storage>();
+			this->storage = this->own_storage.get();
+		}
+		this->storage->in_use = true;
 		this->new_node = nullptr;
 	}
 
+	/** Give the storage back for the next search. */
+	~NodeList()
+	{
+		this->storage->Reset(this->max_nodes);
+		this->storage->in_use = false;
+	}
+
+	NodeList(const NodeList &) = delete;
+	NodeList &operator=(const NodeList &) = delete;
+
+	/**
+	 * Set the number of nodes a search is expected to create, so the memory for those is kept for the next search.
+	 * @param max_search_nodes The maximum number of closed nodes of the search, or 0 when unlimited.
+	 */
+	inline void SetMaxSearchNodes(int max_search_nodes)
+	{
+		/* Next to the closed nodes there are the open ones, which are usually fewer. */
+		this->max_nodes = 2 * static_cast<size_t>(std::max(0, max_search_nodes));
+	}
+
 	/**
 	 * Get open node count.
 	 * @return Number of open nodes.
 	 */
 	inline int OpenCount()
 	{
-		return this->open_nodes.Count();
+		return this->storage->open_nodes.Count();
 	}
 
 	/**
@@ -52,7 +143,7 @@ public:
 	 */
 	inline int ClosedCount()
 	{
-		return this->closed_nodes.Count();
+		return this->storage->closed_nodes.Count();
 	}
 
 	/**
@@ -61,7 +152,7 @@ public:
 	 */
 	inline int TotalCount()
 	{
-		return this->items.Length();
+		return static_cast<int>(this->storage->count);
 	}
 
 	/**
@@ -70,7 +161,14 @@ public:
 	 */
 	inline Titem &CreateNewNode()
 	{
-		if (this->new_node == nullptr) this->new_node = &this->items.emplace_back();
+		if (this->new_node == nullptr) {
+			Storage &storage = *this->storage;
+			if (storage.count == storage.chunks.size() * CHUNK_SIZE) storage.chunks.push_back(std::make_unique<Titem[]>(CHUNK_SIZE));
+			this->new_node = &storage.At(storage.count++);
+			/* Nodes of a previous search have to be reset, as if they were new. */
+			std::destroy_at(this->new_node);
+			std::construct_at(this->new_node);
+		}
 		return *this->new_node;
 	}
 
@@ -93,9 +191,9 @@ public:
 	 */
 	inline void InsertOpenNode(Titem &item)
 	{
-		assert(this->closed_nodes.Find(item.GetKey()) == nullptr);
-		this->open_nodes.Push(item);
-		this->open_queue.Include(&item);
+		assert(this->storage->closed_nodes.Find(item.GetKey()) == nullptr);
+		this->storage->open_nodes.Push(item);
+		this->storage->open_queue.Include(&item);
 		if (&item == this->new_node) {
 			this->new_node = nullptr;
 		}
@@ -107,8 +205,8 @@ public:
 	 */
 	inline Titem *GetBestOpenNode()
 	{
-		if (!this->open_queue.IsEmpty()) {
-			return this->open_queue.Begin();
+		if (!this->storage->open_queue.IsEmpty()) {
+			return this->storage->open_queue.Begin();
 		}
 		return nullptr;
 	}
@@ -119,9 +217,9 @@ public:
 	 */
 	inline Titem *PopBestOpenNode()
 	{
-		if (!this->open_queue.IsEmpty()) {
-			Titem *item = this->open_queue.Shift();
-			this->open_nodes.Pop(*item);
+		if (!this->storage->open_queue.IsEmpty()) {
+			Titem *item = this->storage->open_queue.Shift();
+			this->storage->open_nodes.Pop(*item);
 			return item;
 		}
 		return nullptr;
@@ -134,7 +232,7 @@ public:
 	 */
 	inline Titem *FindOpenNode(const Key &key)
 	{
-		return this->open_nodes.Find(key);
+		return this->storage->open_nodes.Find(key);
 	}
 
 	/**
@@ -144,9 +242,9 @@ public:
 	 */
 	inline Titem &PopOpenNode(const Key &key)
 	{
-		Titem &item = this->open_nodes.Pop(key);
-		size_t index = this->open_queue.FindIndex(item);
-		this->open_queue.Remove(index);
+		Titem &item = this->storage->open_nodes.Pop(key);
+		size_t index = this->storage->open_queue.FindIndex(item);
+		this->storage->open_queue.Remove(index);
 		return item;
 	}
 
@@ -156,8 +254,8 @@ public:
 	 */
 	inline void InsertClosedNode(Titem &item)
 	{
-		assert(this->open_nodes.Find(item.GetKey()) == nullptr);
-		this->closed_nodes.Push(item);
+		assert(this->storage->open_nodes.Find(item.GetKey()) == nullptr);
+		this->storage->closed_nodes.Push(item);
 	}
 
 	/**
@@ -167,7 +265,7 @@ public:
 	 */
 	inline Titem *FindClosedNode(const Key &key)
 	{
-		return this->closed_nodes.Find(key);
+		return this->storage->closed_nodes.Find(key);
 	}
 
 	/**
@@ -177,7 +275,7 @@ public:
 	 */
 	inline Titem &ItemAt(int index)
 	{
-		return this->items[index];
+		return this->storage->At(index);
 	}
 
 	/**
@@ -187,7 +285,8 @@ public:
 	template <class D>
 	void Dump(D &dmp) const
 	{
-		dmp.WriteStructT("data", &this->items);
+		dmp.WriteValue("num_items", this->storage->count);
+		for (size_t i = 0; i < this->storage->count; i++) dmp.WriteStructT(fmt::format("item[{}]", i), &this->storage->At(i));
 	}
 };
 
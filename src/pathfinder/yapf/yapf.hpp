@@ -25,6 +25,7 @@
 #include "yapf_common.hpp"
 #include "yapf_costbase.hpp"
 #include "yapf_costcache.hpp"
+#include "yapf_request_cache.hpp"
 
 
 #endif /* YAPF_HPP */
@@ -14,6 +14,7 @@
 #include "../../settings_type.h"
 #include "../../misc/dbg_helpers.h"
 #include "yapf_type.hpp"
+#include "yapf_benchmark.h"
 
 /**
  * CYapfBaseT - A-star type path finder base class.
@@ -156,6 +157,7 @@ public:
 	inline bool FindPath(const VehicleType *v)
 	{
 		this->vehicle = v;
+		this->nodes.SetMaxSearchNodes(this->max_search_nodes);
 
 		for (;;) {
 			this->num_steps++;
@@ -176,6 +178,10 @@ public:
 
 		const bool destination_found = (this->best_dest_node != nullptr);
 
+		CYapfTotals::s_steps += this->num_steps;
+		CYapfTotals::s_cost_calcs += this->stats_cost_calcs;
+		CYapfTotals::s_cache_hits += this->stats_cache_hits;
+
 		if (_debug_yapf_level >= 3) {
 			const UnitID veh_idx = (this->vehicle != nullptr) ? this->vehicle->unitnumber : 0;
 			const char ttc = Yapf().TransportTypeChar();
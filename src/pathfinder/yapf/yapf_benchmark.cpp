@@ -0,0 +1,276 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/**
+ * @file yapf_benchmark.cpp Recording and replaying the path searches of vehicles, to benchmark the pathfinders.
+ *
+ * A benchmark runs the game for a number of ticks as fast as possible, and
+ * measures every path search of the trains, road vehicles and ships. A
+ * recording is written to a file, together with the savegame and the tick
+ * it started at. Replaying it runs the same ticks again, after loading the
+ * same savegame, and compares the measurements and the chosen tracks with
+ * the recording. As the game is deterministic, both runs
+ * do the same searches until a search chooses a different track.
+ */
+
+#include "../../stdafx.h"
+#include "../../vehicle_base.h"
+#include "../../openttd.h"
+#include "../../console_func.h"
+#include "../../fileio_func.h"
+#include "../../network/network.h"
+#include "../../saveload/saveload.h"
+#include "../../timer/timer_game_tick.h"
+#include "../../core/string_consumer.hpp"
+#include "yapf_benchmark.h"
+
+#include "../../safeguards.h"
+
+uint64_t CYapfTotals::s_steps = 0;
+uint64_t CYapfTotals::s_cost_calcs = 0;
+uint64_t CYapfTotals::s_cache_hits = 0;
+
+bool _yapf_benchmark_active = false; ///< Whether the path searches are being measured.
+
+/** A path search of a vehicle, measured by the benchmark. */
+struct YapfBenchmarkQuery {
+	uint64_t tick; ///< Tick of the search, counted from the start of the benchmark.
+	VehicleType type; ///< Type of the vehicle.
+	VehicleID vehicle; ///< The vehicle.
+	TileIndex tile; ///< Tile the vehicle searched a path from.
+	uint result; ///< The chosen track or trackdir.
+	bool path_found; ///< Whether a path to the destination was found.
+	uint64_t nanoseconds; ///< Time the search took.
+	uint64_t steps; ///< Number of nodes taken from the open list.
+	uint64_t cost_calcs; ///< Number of node costs that were calculated.
+	uint64_t cache_hits; ///< Number of node costs that were taken from the segment cost cache.
+};
+
+/** The game a recording was made in, which a replay has to start from too. */
+struct YapfBenchmarkSetup {
+	uint ticks; ///< Number of ticks the recording ran.
+	std::string savegame; ///< Name of the savegame that was loaded.
+	TimerGameTick::TickCounter start_tick; ///< Tick counter of the game at the start of the recording.
+};
+
+static std::vector<YapfBenchmarkQuery> _yapf_benchmark_queries; ///< The searches of the benchmark.
+static uint64_t _yapf_benchmark_start_tick = 0; ///< The tick the benchmark started at.
+
+/**
+ * Start measuring a path search.
+ * @param v The vehicle searching a path.
+ * @param tile The tile the vehicle searches a path from.
+ */
+void YapfBenchmarkMeasurement::Start(const Vehicle *v, TileIndex tile)
+{
+	this->v = v;
+	this->tile = tile;
+	this->steps = CYapfTotals::s_steps;
+	this->cost_calcs = CYapfTotals::s_cost_calcs;
+	this->cache_hits = CYapfTotals::s_cache_hits;
+	this->start = std::chrono::steady_clock::now();
+}
+
+/**
+ * Finish measuring a path search, and add it to the searches of the benchmark.
+ * @param result The chosen track or trackdir.
+ * @param path_found Whether a path to the destination was found.
+ */
+void YapfBenchmarkMeasurement::Stop(uint result, bool path_found)
+{
+	auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+	_yapf_benchmark_queries.push_back({TimerGameTick::counter - _yapf_benchmark_start_tick, this->v->type, this->v->index, this->tile, result, path_found,
+			static_cast<uint64_t>(nanoseconds), CYapfTotals::s_steps - this->steps, CYapfTotals::s_cost_calcs - this->cost_calcs, CYapfTotals::s_cache_hits - this->cache_hits});
+}
+
+/**
+ * Run the game for some ticks, measuring all path searches.
+ * @param ticks The number of ticks to run.
+ * @return The measured searches, or \c std::nullopt if the game cannot be run.
+ */
+static std::optional<std::vector<YapfBenchmarkQuery>> RunYapfBenchmark(uint ticks)
+{
+	if (_game_mode != GM_NORMAL || _networking || _pause_mode.Any()) {
+		IConsolePrint(CC_ERROR, "The pathfinder benchmark can only run in an unpaused single player game.");
+		return std::nullopt;
+	}
+
+	_yapf_benchmark_queries.clear();
+	_yapf_benchmark_start_tick = TimerGameTick::counter;
+	_yapf_benchmark_active = true;
+	for (uint i = 0; i < ticks; i++) StateGameLoop();
+	_yapf_benchmark_active = false;
+
+	return std::move(_yapf_benchmark_queries);
+}
+
+/**
+ * Print the totals of the searches of each vehicle type.
+ * @param name The name of the run.
+ * @param queries The searches.
+ */
+static void PrintYapfBenchmarkTotals(std::string_view name, const std::vector<YapfBenchmarkQuery> &queries)
+{
+	static const std::pair<VehicleType, std::string_view> types[] = {{VehicleType::Train, "trains"}, {VehicleType::Road, "road vehicles"}, {VehicleType::Ship, "ships"}};
+
+	IConsolePrint(CC_INFO, "{}:", name);
+	for (const auto &[type, type_name] : types) {
+		YapfBenchmarkQuery total{};
+		uint searches = 0;
+		for (const YapfBenchmarkQuery &query : queries) {
+			if (query.type != type) continue;
+			searches++;
+			total.nanoseconds += query.nanoseconds;
+			total.steps += query.steps;
+			total.cost_calcs += query.cost_calcs;
+			total.cache_hits += query.cache_hits;
+		}
+		if (searches == 0) continue;
+		IConsolePrint(CC_DEFAULT, "  {}: {} searches, {:.1f} ms, {} nodes expanded, {} costs calculated, {} cache hits",
+				type_name, searches, total.nanoseconds / 1e6, total.steps, total.cost_calcs, total.cache_hits);
+	}
+}
+
+/**
+ * Run the game for some ticks, and record all path searches to a file.
+ * @param ticks The number of ticks to run.
+ * @param filename The file to write the recording to.
+ * @return True if the game could be run.
+ */
+bool YapfBenchmarkRecord(uint ticks, const std::string &filename)
+{
+	YapfBenchmarkSetup setup{ticks, _file_to_saveload.name, TimerGameTick::counter};
+	auto queries = RunYapfBenchmark(ticks);
+	if (!queries.has_value()) return false;
+
+	PrintYapfBenchmarkTotals(fmt::format("Recorded {} ticks", ticks), *queries);
+
+	auto f = FioFOpenFile(filename, "wt", Subdirectory::None);
+	if (!f.has_value()) {
+		IConsolePrint(CC_ERROR, "Failed to open '{}' for writing.", filename);
+		return false;
+	}
+
+	fmt::print(*f, "Ticks,{}\n", setup.ticks);
+	fmt::print(*f, "Savegame,{}\n", setup.savegame);
+	fmt::print(*f, "StartTick,{}\n", setup.start_tick);
+	fmt::print(*f, "Tick,Type,Vehicle,Tile,Result,PathFound,Nanoseconds,Steps,CostCalcs,CacheHits\n");
+	for (const YapfBenchmarkQuery &q : *queries) {
+		fmt::print(*f, "{},{},{},{},{},{},{},{},{},{}\n", q.tick, to_underlying(q.type), q.vehicle.base(), q.tile.base(), q.result, q.path_found ? 1 : 0, q.nanoseconds, q.steps, q.cost_calcs, q.cache_hits);
+	}
+	IConsolePrint(CC_INFO, "Wrote {} path searches to '{}'.", queries->size(), filename);
+	return true;
+}
+
+/**
+ * Read a recording of path searches.
+ * @param filename The file to read.
+ * @param[out] setup The game the recording was made in.
+ * @return The recorded searches, or \c std::nullopt if the file could not be read.
+ */
+static std::optional<std::vector<YapfBenchmarkQuery>> ReadYapfBenchmarkRecording(const std::string &filename, YapfBenchmarkSetup &setup)
+{
+	size_t filesize;
+	auto f = FioFOpenFile(filename, "rb", Subdirectory::None, &filesize);
+	if (!f.has_value()) return std::nullopt;
+
+	std::string buffer(filesize, '\0');
+	if (fread(buffer.data(), 1, buffer.size(), *f) != buffer.size()) return std::nullopt;
+
+	StringConsumer consumer(buffer);
+	auto read_header = [&consumer](std::string_view name) -> std::optional<std::string_view> {
+		StringConsumer header(consumer.ReadUntilChar('\n', StringConsumer::SKIP_ONE_SEPARATOR));
+		if (header.ReadUntilChar(',', StringConsumer::SKIP_ONE_SEPARATOR) != name) return std::nullopt;
+		return header.Read(StringConsumer::npos);
+	};
+
+	auto ticks = read_header("Ticks");
+	auto recorded_ticks = ticks.has_value() ? ParseInteger<uint>(*ticks) : std::nullopt;
+	if (!recorded_ticks.has_value()) return std::nullopt;
+	setup.ticks = *recorded_ticks;
+
+	auto savegame = read_header("Savegame");
+	if (!savegame.has_value()) return std::nullopt;
+	setup.savegame = *savegame;
+
+	auto start_tick = read_header("StartTick");
+	auto recorded_start_tick = start_tick.has_value() ? ParseInteger<TimerGameTick::TickCounter>(*start_tick) : std::nullopt;
+	if (!recorded_start_tick.has_value()) return std::nullopt;
+	setup.start_tick = *recorded_start_tick;
+
+	consumer.SkipUntilChar('\n', StringConsumer::SKIP_ONE_SEPARATOR); // Column names.
+
+	std::vector<YapfBenchmarkQuery> queries;
+	while (consumer.AnyBytesLeft()) {
+		StringConsumer line(consumer.ReadUntilChar('\n', StringConsumer::SKIP_ONE_SEPARATOR));
+		if (!line.AnyBytesLeft()) continue;
+
+		std::array<uint64_t, 10> fields;
+		for (uint64_t &field : fields) {
+			auto value = ParseInteger<uint64_t>(line.ReadUntilChar(',', StringConsumer::SKIP_ONE_SEPARATOR));
+			if (!value.has_value()) return std::nullopt;
+			field = *value;
+		}
+		queries.push_back({fields[0], static_cast<VehicleType>(fields[1]), VehicleID(static_cast<VehicleID::BaseType>(fields[2])), TileIndex(static_cast<uint32_t>(fields[3])),
+				static_cast<uint>(fields[4]), fields[5] != 0, fields[6], fields[7], fields[8], fields[9]});
+	}
+	return queries;
+}
+
+/**
+ * Run the game for as many ticks as a recording, and compare the path searches with it.
+ * The game has to be the savegame the recording started from, at the same tick.
+ * @param filename The file with the recording.
+ * @return True if the recording could be read and the game could be run.
+ */
+bool YapfBenchmarkReplay(const std::string &filename)
+{
+	YapfBenchmarkSetup setup{};
+	auto recorded = ReadYapfBenchmarkRecording(filename, setup);
+	if (!recorded.has_value()) {
+		IConsolePrint(CC_ERROR, "Failed to read a pathfinder benchmark recording from '{}'.", filename);
+		return false;
+	}
+
+	/* Replaying from any other game only compares unrelated searches. */
+	if (setup.savegame != _file_to_saveload.name || setup.start_tick != TimerGameTick::counter) {
+		IConsolePrint(CC_ERROR, "The recording started at tick {} of savegame '{}'; load that savegame before replaying.", setup.start_tick, setup.savegame);
+		return false;
+	}
+
+	const uint ticks = setup.ticks;
+	auto replayed = RunYapfBenchmark(ticks);
+	if (!replayed.has_value()) return false;
+
+	PrintYapfBenchmarkTotals("Recording", *recorded);
+	PrintYapfBenchmarkTotals(fmt::format("Replay of {} ticks", ticks), *replayed);
+
+	/* Both runs do the same searches, until one of them chose a different track. */
+	size_t compared = 0;
+	size_t same = 0;
+	const YapfBenchmarkQuery *first_difference = nullptr;
+	for (; compared < std::min(recorded->size(), replayed->size()); compared++) {
+		const YapfBenchmarkQuery &a = (*recorded)[compared];
+		const YapfBenchmarkQuery &b = (*replayed)[compared];
+		if (a.tick != b.tick || a.type != b.type || a.vehicle != b.vehicle || a.tile != b.tile) break;
+
+		if (a.result == b.result && a.path_found == b.path_found) {
+			same++;
+		} else if (first_difference == nullptr) {
+			first_difference = &a;
+		}
+	}
+
+	IConsolePrint(same == recorded->size() && same == replayed->size() ? CC_INFO : CC_WARNING, "{} of {} recorded path searches chose the same track.", same, recorded->size());
+	if (first_difference != nullptr) {
+		IConsolePrint(CC_WARNING, "First different search: tick {}, vehicle {}, tile 0x{:X}.", first_difference->tick, first_difference->vehicle, first_difference->tile);
+	}
+	if (compared != recorded->size() || compared != replayed->size()) {
+		IConsolePrint(CC_WARNING, "The games diverged after {} path searches.", compared);
+	}
+	return true;
+}
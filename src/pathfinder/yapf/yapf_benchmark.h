@@ -0,0 +1,63 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_benchmark.h Recording and replaying the path searches of vehicles, to benchmark the pathfinders. */
+
+#ifndef YAPF_BENCHMARK_H
+#define YAPF_BENCHMARK_H
+
+#include "../../vehicle_type.h"
+#include "../../tile_type.h"
+#include <chrono>
+
+/** Totals of the statistics of all path searches, summed over all pathfinders. */
+struct CYapfTotals {
+	static uint64_t s_steps; ///< Number of nodes taken from the open list.
+	static uint64_t s_cost_calcs; ///< Number of node costs that were calculated.
+	static uint64_t s_cache_hits; ///< Number of node costs that were taken from the segment cost cache.
+};
+
+extern bool _yapf_benchmark_active;
+
+/** Measurement of a single path search of a vehicle, while a benchmark is running. */
+class YapfBenchmarkMeasurement {
+	const Vehicle *v = nullptr; ///< The vehicle searching a path.
+	TileIndex tile = INVALID_TILE; ///< The tile the vehicle searches a path from.
+	std::chrono::steady_clock::time_point start; ///< When the search started.
+	uint64_t steps = 0; ///< #CYapfTotals::s_steps when the search started.
+	uint64_t cost_calcs = 0; ///< #CYapfTotals::s_cost_calcs when the search started.
+	uint64_t cache_hits = 0; ///< #CYapfTotals::s_cache_hits when the search started.
+
+	void Start(const Vehicle *v, TileIndex tile);
+	void Stop(uint result, bool path_found);
+
+public:
+	/**
+	 * Start measuring a path search, if a benchmark is running.
+	 * @param v The vehicle searching a path.
+	 * @param tile The tile the vehicle searches a path from.
+	 */
+	inline YapfBenchmarkMeasurement(const Vehicle *v, TileIndex tile)
+	{
+		if (_yapf_benchmark_active) this->Start(v, tile);
+	}
+
+	/**
+	 * Finish measuring the path search.
+	 * @param result The chosen track or trackdir.
+	 * @param path_found Whether a path to the destination was found.
+	 */
+	inline void Finish(uint result, bool path_found)
+	{
+		if (_yapf_benchmark_active) this->Stop(result, path_found);
+	}
+};
+
+bool YapfBenchmarkRecord(uint ticks, const std::string &filename);
+bool YapfBenchmarkReplay(const std::string &filename);
+
+#endif /* YAPF_BENCHMARK_H */
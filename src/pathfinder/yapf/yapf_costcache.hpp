@@ -11,6 +11,7 @@
 #define YAPF_COSTCACHE_HPP
 
 #include "../../misc/hashtable.hpp"
+#include "../../company_type.h"
 #include "../../tile_type.h"
 #include "../../track_type.h"
 
@@ -41,13 +42,39 @@ public:
  *  the track layout changes. It is implemented as base class because it needs
  *  to be shared between all rail YAPF types (one shared counter, one notification
  *  function.
+ *
+ * A segment only consists of tiles of the owner of the train, so a change of
+ *  the tracks of one company does not change the segments of the others. Such
+ *  changes only increment the change counter of that owner, which invalidates
+ *  the segments of that owner when they are fetched next.
  */
 struct CSegmentCostCacheBase {
-	static int   s_rail_change_counter;
+	static int   s_rail_change_counter; ///< Counter of the changes that invalidate the segments of all owners.
+	static std::array<uint32_t, MAX_COMPANIES> s_owner_change_counters; ///< Counters of the changes that only invalidate the segments of one owner.
 
-	static void NotifyTrackLayoutChange(TileIndex, Track)
+	static void NotifyTrackLayoutChange(TileIndex tile, Track track);
+
+	/**
+	 * Notify that the costs of the segments of an owner changed.
+	 * @param owner The owner of the changed tracks.
+	 */
+	static void NotifyOwnerChange(Owner owner)
 	{
-		s_rail_change_counter++;
+		if (owner.base() < MAX_COMPANIES) {
+			s_owner_change_counters[owner.base()]++;
+		} else {
+			s_rail_change_counter++;
+		}
+	}
+
+	/**
+	 * Get the change counter of the segments of an owner.
+	 * @param owner The owner of the segments.
+	 * @return The counter; segments computed with another value are invalid.
+	 */
+	static uint32_t GetOwnerChangeCounter(Owner owner)
+	{
+		return owner.base() < MAX_COMPANIES ? s_owner_change_counters[owner.base()] : 0;
 	}
 };
 
@@ -80,16 +107,32 @@ struct CSegmentCostCacheT : public CSegmentCostCacheBase {
 		this->heap.clear();
 	}
 
-	inline Tsegment &Get(Key &key, bool *found)
+	/**
+	 * Get the segment with the given key, valid for the given owner.
+	 * A segment of which the tracks changed since it was calculated is cleared.
+	 * @param key The key of the segment.
+	 * @param owner The owner of the tracks of the segment.
+	 * @param[out] found Whether a valid segment was found.
+	 * @return The segment.
+	 */
+	inline Tsegment &Get(Key &key, Owner owner, bool *found)
 	{
+		uint32_t change_counter = CSegmentCostCacheBase::GetOwnerChangeCounter(owner);
 		Tsegment *item = this->map.Find(key);
 		if (item == nullptr) {
 			*found = false;
 			item = &this->heap.emplace_back(key);
 			this->map.Push(*item);
+		} else if (item->owner != owner || item->owner_change_counter != change_counter) {
+			*found = false;
+			Tsegment *next = item->GetHashNext();
+			*item = Tsegment(key);
+			item->SetHashNext(next);
 		} else {
 			*found = true;
 		}
+		item->owner = owner;
+		item->owner_change_counter = change_counter;
 		return *item;
 	}
 };
@@ -151,7 +194,7 @@ public:
 		}
 
 		bool found;
-		CachedData &item = this->global_cache.Get(key, &found);
+		CachedData &item = this->global_cache.Get(key, Yapf().GetVehicle()->owner, &found);
 		Yapf().ConnectNodeToCachedData(n, item);
 		return found;
 	}
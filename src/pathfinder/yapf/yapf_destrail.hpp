@@ -13,6 +13,7 @@
 #include "../../train.h"
 #include "../pathfinder_func.h"
 #include "../pathfinder_type.h"
+#include "yapf_rail_landmarks.h"
 
 class CYapfDestinationRailBase {
 protected:
@@ -116,6 +117,7 @@ protected:
 	TrackdirBits dest_trackdirs;
 	StationID dest_station_id;
 	bool any_depot;
+	RailLandmarkTarget landmark_target; ///< Distances of the destination to the landmarks, if the landmark heuristic is enabled.
 
 	/** @copydoc CYapfBaseT::Yapf */
 	Tpf &Yapf()
@@ -158,6 +160,26 @@ public:
 				break;
 		}
 		this->CYapfDestinationRailBase::SetDestination(v);
+		this->SetLandmarkTarget();
+	}
+
+	/** Get the distances of the destination to the landmarks, when the landmark heuristic is enabled. */
+	void SetLandmarkTarget()
+	{
+		this->landmark_target = {};
+		if (!Yapf().PfGetSettings().rail_landmarks || this->any_depot) return;
+
+		if (this->dest_station_id == StationID::Invalid()) {
+			this->landmark_target = YapfRailGetLandmarkTarget({&this->dest_tile, 1});
+			return;
+		}
+
+		/* Any platform of the station is fine, so the estimate must not exceed the distance to the nearest one. */
+		std::vector<TileIndex> tiles;
+		for (TileIndex tile : BaseStation::Get(this->dest_station_id)->train_station) {
+			if (HasStationTileRail(tile) && GetStationIndex(tile) == this->dest_station_id) tiles.push_back(tile);
+		}
+		this->landmark_target = YapfRailGetLandmarkTarget(tiles);
 	}
 
 	/** @copydoc CYapfBaseT::PfDetectDestinationFunc */
@@ -191,6 +213,9 @@ public:
 		}
 
 		n.estimate = n.cost + OctileDistanceCost(n.GetLastTile(), n.GetLastTrackdir(), this->dest_tile);
+		if (this->landmark_target.IsValid()) {
+			n.estimate = std::max(n.estimate, n.cost + YapfRailGetLandmarkEstimate(n.GetLastTile(), this->landmark_target));
+		}
 		assert(n.estimate >= n.parent->estimate);
 		return true;
 	}
@@ -73,6 +73,8 @@ struct CYapfRailSegment {
 	TileIndex last_signal_tile = INVALID_TILE;
 	Trackdir last_signal_td = INVALID_TRACKDIR;
 	EndSegmentReasons end_segment_reason{};
+	Owner owner = INVALID_OWNER; ///< Owner of the tracks of the segment.
+	uint32_t owner_change_counter = 0; ///< Change counter of the owner when the segment was calculated.
 	CYapfRailSegment *hash_next = nullptr;
 
 	inline CYapfRailSegment(const CYapfRailSegmentKey &key) : key(key) {}
@@ -106,6 +108,7 @@ struct CYapfRailSegment {
 		dmp.WriteTile("last_signal_tile", this->last_signal_tile);
 		dmp.WriteEnumT("last_signal_td", this->last_signal_td);
 		dmp.WriteEnumT("end_segment_reason", this->end_segment_reason);
+		dmp.WriteValue("owner", this->owner.base());
 	}
 };
 
@@ -227,7 +227,8 @@ public:
 		if (target != nullptr) target->okay = true;
 
 		if (Yapf().CanUseGlobalCache(*this->res_dest_node)) {
-			YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+			/* The reservation changed the costs, not the layout. */
+			CSegmentCostCacheBase::NotifyOwnerChange(Yapf().GetVehicle()->owner);
 		}
 
 		return true;
@@ -596,11 +597,15 @@ struct CYapfAnySafeTileRailNo90 : CYapfRailBase<CYapfRail_TypesT<CYapfAnySafeTil
 
 Track YapfTrainChooseTrack(const Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool &path_found, bool reserve_track, PBSTileInfo *target, TileIndex *dest)
 {
+	YapfBenchmarkMeasurement measurement(v, tile);
+
 	Trackdir td_ret = _settings_game.pf.forbid_90_deg
 		? CYapfRailNo90::stChooseRailTrack(v, tile, enterdir, tracks, path_found, reserve_track, target, dest)
 		: CYapfRail::stChooseRailTrack(v, tile, enterdir, tracks, path_found, reserve_track, target, dest);
 
-	return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : FindFirstTrack(tracks);
+	Track track = (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : FindFirstTrack(tracks);
+	measurement.Finish(track, path_found);
+	return track;
 }
 
 bool YapfTrainCheckReverse(const Train *v)
@@ -689,8 +694,26 @@ bool YapfTrainFindNearestSafeTile(const Train *v, TileIndex tile, Trackdir td, b
 
 /** if any track changes, this counter is incremented - that will invalidate segment cost cache */
 int CSegmentCostCacheBase::s_rail_change_counter = 0;
+std::array<uint32_t, MAX_COMPANIES> CSegmentCostCacheBase::s_owner_change_counters{};
+
+/**
+ * Notify that the track layout of a tile changed.
+ * If the tile has tracks of a company, only the segments of that company are
+ * invalidated. Otherwise, e.g. when the last track of the tile was removed,
+ * the segments of all companies are.
+ * @param tile The changed tile, or \c INVALID_TILE if unknown.
+ */
+void CSegmentCostCacheBase::NotifyTrackLayoutChange(TileIndex tile, Track)
+{
+	if (tile == INVALID_TILE || TrackStatusToTrackBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, RoadTramType::Invalid)) == TRACK_BIT_NONE) {
+		s_rail_change_counter++;
+		return;
+	}
+	NotifyOwnerChange(GetTileOwner(tile));
+}
 
 void YapfNotifyTrackLayoutChange(TileIndex tile, Track track)
 {
 	CSegmentCostCacheBase::NotifyTrackLayoutChange(tile, track);
+	YapfRailInvalidateLandmarks(tile);
 }
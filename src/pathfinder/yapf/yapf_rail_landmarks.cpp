@@ -0,0 +1,406 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/**
+ * @file yapf_rail_landmarks.cpp Lower bounds of the distances over rail, from the distances to landmarks.
+ *
+ * The rail tiles form a graph, in which neighbouring tiles are connected when
+ * a track of one leads into a track of the other. Each rail network, i.e.
+ * each connected part of the graph, gets a few landmarks spread over it, and
+ * the distance over rail of every tile to those landmarks is known. Following
+ * the triangle inequality, the difference between the distances of two tiles
+ * to a landmark is a lower bound of the distance between those tiles.
+ *
+ * The graph ignores signals, rail types and owners, and every step costs the
+ * least a train pays for entering a tile. So these distances are never longer
+ * than what a train pays to get from one tile to another, and the estimate
+ * stays admissible and consistent. As the landmarks only depend on the track
+ * layout, every client chooses the same ones.
+ *
+ * The landmarks of a network are only chosen when a train first looks for a
+ * destination in it. A change of the track layout only makes the networks
+ * around the changed tile choose their landmarks again, and only when the
+ * connections between their tiles actually changed.
+ */
+
+#include "../../stdafx.h"
+#include "../../map_func.h"
+#include "../../station_map.h"
+#include "../../road_map.h"
+#include "../../tunnelbridge_map.h"
+#include "../../tunnelbridge.h"
+#include "../../rail_map.h"
+#include "../../landscape.h"
+#include "../pathfinder_type.h"
+#include "yapf_rail_landmarks.h"
+#include <numeric>
+#include <queue>
+
+#include "../../safeguards.h"
+
+/** Lower bounds of the distances over rail between tiles, from their distances to a few landmarks. */
+class RailLandmarks {
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX; ///< Index of a missing neighbour.
+	static constexpr uint32_t INFINITE_DISTANCE = UINT32_MAX; ///< Distance to a tile that has not been reached.
+	static constexpr uint8_t WORMHOLE = 1U << DIAGDIR_END; ///< Connection of a tunnel or bridge head to its other end.
+	static constexpr uint8_t NO_RAIL = UINT8_MAX; ///< Connections of a tile without rail.
+	static constexpr size_t MAX_CHANGED_TILES = 1U << 16; ///< Number of changed tiles after which all networks are forgotten instead.
+
+	/** What is known about a rail tile of a network with landmarks. */
+	struct TileData {
+		uint32_t network; ///< The network of the tile.
+		uint8_t connections; ///< The directions in which the tile is connected to its neighbours, see #GetConnections.
+		std::array<uint32_t, MAX_RAIL_LANDMARKS> distances; ///< Distances of the tile to the landmarks of its network.
+	};
+
+	std::unordered_map<TileIndex, TileData> tile_data; ///< The tiles of all networks with landmarks.
+	std::unordered_map<uint32_t, std::vector<TileIndex>> network_tiles; ///< The tiles of each network with landmarks.
+	std::vector<TileIndex> changed_tiles; ///< Tiles of which the track layout changed since the networks were last checked.
+	uint32_t next_network = 0; ///< Number of the next network to add.
+
+	/**
+	 * Check whether a tile has rail, which trains can use.
+	 * @param tile The tile.
+	 * @return True if the tile has rail.
+	 */
+	static bool HasRail(TileIndex tile)
+	{
+		switch (GetTileType(tile)) {
+			case TileType::Railway: return true;
+			case TileType::Road: return IsLevelCrossing(tile);
+			case TileType::Station: return HasStationRail(tile);
+			case TileType::TunnelBridge: return GetTunnelBridgeTransportType(tile) == TRANSPORT_RAIL;
+			default: return false;
+		}
+	}
+
+	/**
+	 * Find the rail tile a train leaving a rail tile in a direction gets to.
+	 * @param tile The tile.
+	 * @param exitdir The direction the train leaves the tile in.
+	 * @return The next tile, or \c INVALID_TILE if there is no connected rail in that direction.
+	 */
+	static TileIndex GetNeighbour(TileIndex tile, DiagDirection exitdir)
+	{
+		if (IsRailDepotTile(tile) && GetRailDepotDirection(tile) != exitdir) return INVALID_TILE;
+
+		/* Trains entering a tunnel or bridge come out at its other end. */
+		bool wormhole = IsTileType(tile, TileType::TunnelBridge) && GetTunnelBridgeDirection(tile) == exitdir;
+		TileIndex next = wormhole ? GetOtherTunnelBridgeEnd(tile) : AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(exitdir));
+		if (next == INVALID_TILE || !HasRail(next)) return INVALID_TILE;
+
+		/* Tunnels, bridges and depots can only be entered from their front. */
+		if (!wormhole && IsTileType(next, TileType::TunnelBridge) && GetTunnelBridgeDirection(next) != exitdir) return INVALID_TILE;
+		if (IsRailDepotTile(next) && GetRailDepotDirection(next) != ReverseDiagDir(exitdir)) return INVALID_TILE;
+
+		TrackdirBits next_trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(next, TRANSPORT_RAIL, RoadTramType::Invalid));
+		return (next_trackdirs & DiagdirReachesTrackdirs(exitdir)) != TRACKDIR_BIT_NONE ? next : INVALID_TILE;
+	}
+
+	/**
+	 * Find the rail tiles connected to a rail tile.
+	 * @param tile The tile.
+	 * @return The connected tile in each direction, \c INVALID_TILE where there is none.
+	 */
+	static std::array<TileIndex, DIAGDIR_END> GetNeighbours(TileIndex tile)
+	{
+		std::array<TileIndex, DIAGDIR_END> neighbours;
+		neighbours.fill(INVALID_TILE);
+		TrackdirBits trackdirs = TrackStatusToTrackdirBits(GetTileTrackStatus(tile, TRANSPORT_RAIL, RoadTramType::Invalid));
+		for (Trackdir td : SetTrackdirBitIterator(trackdirs)) {
+			DiagDirection exitdir = TrackdirToExitdir(td);
+			if (neighbours[exitdir] == INVALID_TILE) neighbours[exitdir] = GetNeighbour(tile, exitdir);
+		}
+		return neighbours;
+	}
+
+	/**
+	 * Get how a tile is connected to its neighbours.
+	 * @param tile The tile.
+	 * @param neighbours The connected tiles of the tile.
+	 * @return A bit for each direction with a connected tile, plus #WORMHOLE for tunnel and bridge heads.
+	 */
+	static uint8_t GetConnections(TileIndex tile, const std::array<TileIndex, DIAGDIR_END> &neighbours)
+	{
+		uint8_t connections = IsTileType(tile, TileType::TunnelBridge) ? WORMHOLE : 0;
+		for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+			if (neighbours[dir] != INVALID_TILE) SetBit(connections, dir);
+		}
+		return connections;
+	}
+
+	/**
+	 * Get how a tile is connected to its neighbours.
+	 * @param tile The tile.
+	 * @return A bit for each direction with a connected tile, plus #WORMHOLE for tunnel and bridge heads, or #NO_RAIL.
+	 */
+	static uint8_t GetConnections(TileIndex tile)
+	{
+		return HasRail(tile) ? GetConnections(tile, GetNeighbours(tile)) : NO_RAIL;
+	}
+
+	/**
+	 * Calculate the distances of all tiles of a network to a tile. Tiles
+	 * are always connected both ways, so these are the distances from the
+	 * tile as well as to it.
+	 * @param tiles The tiles of the network.
+	 * @param neighbours The indices of the connected tiles of each tile.
+	 * @param source The index of the tile.
+	 * @param[out] distances The distances.
+	 */
+	static void CalculateDistances(std::span<const TileIndex> tiles, std::span<const std::array<uint32_t, DIAGDIR_END>> neighbours, uint32_t source, std::vector<uint32_t> &distances)
+	{
+		using Item = std::pair<uint32_t, uint32_t>; // distance, index
+		std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+		distances.assign(tiles.size(), INFINITE_DISTANCE);
+		distances[source] = 0;
+		queue.emplace(0, source);
+		while (!queue.empty()) {
+			auto [distance, i] = queue.top();
+			queue.pop();
+			if (distance > distances[i]) continue;
+			for (uint32_t j : neighbours[i]) {
+				if (j == INVALID_INDEX) continue;
+				/* Every tile costs at least its corner length, skipped tunnel and bridge tiles even more. */
+				uint32_t new_distance = distance + DistanceManhattan(tiles[i], tiles[j]) * YAPF_TILE_CORNER_LENGTH;
+				if (new_distance < distances[j]) {
+					distances[j] = new_distance;
+					queue.emplace(new_distance, j);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Forget the landmarks of a network.
+	 * @param network The network.
+	 */
+	void RemoveNetwork(uint32_t network)
+	{
+		auto it = this->network_tiles.find(network);
+		if (it == this->network_tiles.end()) return;
+		for (TileIndex tile : it->second) this->tile_data.erase(tile);
+		this->network_tiles.erase(it);
+	}
+
+	/**
+	 * Forget the landmarks of the network of a tile, if the connections of the tile changed.
+	 * @param tile The tile.
+	 */
+	void CheckTile(TileIndex tile)
+	{
+		auto it = this->tile_data.find(tile);
+		if (it != this->tile_data.end() && it->second.connections != GetConnections(tile)) this->RemoveNetwork(it->second.network);
+	}
+
+	/**
+	 * Check a changed tile and its neighbours.
+	 * @param tile The tile.
+	 */
+	void CheckTileAndNeighbours(TileIndex tile)
+	{
+		this->CheckTile(tile);
+		for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+			TileIndex neighbour = AddTileIndexDiffCWrap(tile, TileIndexDiffCByDiagDir(dir));
+			if (neighbour != INVALID_TILE) this->CheckTile(neighbour);
+		}
+	}
+
+	/**
+	 * Forget the landmarks of the networks whose track layout changed. The
+	 * other networks keep the landmarks they would get when choosing them
+	 * again, so the landmarks of all networks stay the same on every client.
+	 */
+	void CheckChangedTiles()
+	{
+		for (TileIndex tile : this->changed_tiles) {
+			this->CheckTileAndNeighbours(tile);
+			/* A new tunnel or bridge connects to the tiles around its other end as well. */
+			if (IsTileType(tile, TileType::TunnelBridge) && GetTunnelBridgeTransportType(tile) == TRANSPORT_RAIL) this->CheckTileAndNeighbours(GetOtherTunnelBridgeEnd(tile));
+		}
+		this->changed_tiles.clear();
+	}
+
+	/**
+	 * Find the rail network of a tile, choose its landmarks and store the
+	 * distances to them. The first landmark is the tile farthest from the
+	 * network's first tile, each next one the tile farthest from all
+	 * landmarks chosen so far.
+	 * @param seed A rail tile of the network.
+	 */
+	void AddNetwork(TileIndex seed)
+	{
+		/* Find the tiles of the network and how they are connected. */
+		std::vector<TileIndex> tiles{seed};
+		std::vector<std::array<uint32_t, DIAGDIR_END>> neighbours;
+		std::vector<uint8_t> connections;
+		std::unordered_map<TileIndex, uint32_t> indices{{seed, 0}};
+		for (uint32_t i = 0; i < tiles.size(); i++) {
+			std::array<TileIndex, DIAGDIR_END> next_tiles = GetNeighbours(tiles[i]);
+			connections.push_back(GetConnections(tiles[i], next_tiles));
+			neighbours.push_back({INVALID_INDEX, INVALID_INDEX, INVALID_INDEX, INVALID_INDEX});
+			for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+				TileIndex next = next_tiles[dir];
+				if (next == INVALID_TILE) continue;
+				auto [it, inserted] = indices.try_emplace(next, static_cast<uint32_t>(tiles.size()));
+				if (inserted) tiles.push_back(next);
+				neighbours[i][dir] = it->second;
+			}
+		}
+
+		/* A network this one reached was missed when checking the changed tiles; it is part of this one now. */
+		for (TileIndex tile : tiles) {
+			auto it = this->tile_data.find(tile);
+			if (it != this->tile_data.end()) this->RemoveNetwork(it->second.network);
+		}
+
+		/* Ties are broken by the order of the tiles on the map. */
+		std::vector<uint32_t> members(tiles.size());
+		std::iota(members.begin(), members.end(), 0);
+		std::ranges::sort(members, {}, [&tiles](uint32_t i) { return tiles[i]; });
+
+		/* Distance of each tile to the nearest landmark chosen so far; for the first landmark to the first tile. */
+		std::vector<uint32_t> nearest;
+		CalculateDistances(tiles, neighbours, members.front(), nearest);
+
+		std::vector<std::array<uint32_t, MAX_RAIL_LANDMARKS>> landmark_distances(tiles.size());
+		std::vector<uint32_t> distances;
+		for (uint landmark = 0; landmark < MAX_RAIL_LANDMARKS; landmark++) {
+			uint32_t best = members.front();
+			uint32_t best_distance = 0;
+			for (uint32_t i : members) {
+				if (nearest[i] > best_distance) {
+					best = i;
+					best_distance = nearest[i];
+				}
+			}
+			/* Every tile is a landmark already. */
+			if (landmark > 0 && best_distance == 0) break;
+
+			CalculateDistances(tiles, neighbours, best, distances);
+			for (uint32_t i = 0; i < tiles.size(); i++) {
+				landmark_distances[i][landmark] = distances[i];
+				nearest[i] = (landmark == 0) ? distances[i] : std::min(nearest[i], distances[i]);
+			}
+		}
+
+		uint32_t network = this->next_network++;
+		for (uint32_t i = 0; i < tiles.size(); i++) {
+			this->tile_data[tiles[i]] = {network, connections[i], landmark_distances[i]};
+		}
+		this->network_tiles[network] = std::move(tiles);
+	}
+
+public:
+	/**
+	 * Get the landmarks.
+	 * @return The landmarks.
+	 */
+	static RailLandmarks &Get()
+	{
+		static RailLandmarks landmarks;
+		return landmarks;
+	}
+
+	/**
+	 * Notify that the track layout of a tile changed.
+	 * @param tile The tile, or \c INVALID_TILE to forget the landmarks of all networks.
+	 */
+	void NotifyTrackLayoutChange(TileIndex tile)
+	{
+		if (tile == INVALID_TILE || this->changed_tiles.size() >= MAX_CHANGED_TILES) {
+			this->tile_data.clear();
+			this->network_tiles.clear();
+			this->changed_tiles.clear();
+			return;
+		}
+		/* Without any landmarks there is nothing a change could make invalid. */
+		if (!this->tile_data.empty()) this->changed_tiles.push_back(tile);
+	}
+
+	/**
+	 * Get the distances of a destination to the landmarks, after choosing
+	 * the landmarks of its network if they are not known.
+	 * @param tiles The tiles of the destination.
+	 * @return The distances, or an invalid target if the tiles are not all in the same network.
+	 */
+	RailLandmarkTarget GetTarget(std::span<const TileIndex> tiles)
+	{
+		this->CheckChangedTiles();
+
+		RailLandmarkTarget target;
+		bool first = true;
+		for (TileIndex tile : tiles) {
+			if (!HasRail(tile)) return {};
+			if (!this->tile_data.contains(tile)) this->AddNetwork(tile);
+			const TileData &data = this->tile_data.at(tile);
+			if (first) {
+				target.network = data.network;
+				target.min_distances.fill(UINT32_MAX);
+				first = false;
+			} else if (target.network != data.network) {
+				return {};
+			}
+			for (uint landmark = 0; landmark < MAX_RAIL_LANDMARKS; landmark++) {
+				target.min_distances[landmark] = std::min(target.min_distances[landmark], data.distances[landmark]);
+				target.max_distances[landmark] = std::max(target.max_distances[landmark], data.distances[landmark]);
+			}
+		}
+		return target;
+	}
+
+	/**
+	 * Get a lower bound of the cost for a train to get from a tile to a destination.
+	 * @param tile The tile.
+	 * @param target The distances of the destination to the landmarks.
+	 * @return The lower bound, 0 if nothing is known about the tile.
+	 */
+	int GetEstimate(TileIndex tile, const RailLandmarkTarget &target) const
+	{
+		auto it = this->tile_data.find(tile);
+		if (it == this->tile_data.end() || it->second.network != target.network) return 0;
+
+		uint32_t estimate = 0;
+		for (uint landmark = 0; landmark < MAX_RAIL_LANDMARKS; landmark++) {
+			uint32_t distance = it->second.distances[landmark];
+			if (distance < target.min_distances[landmark]) estimate = std::max(estimate, target.min_distances[landmark] - distance);
+			if (distance > target.max_distances[landmark]) estimate = std::max(estimate, distance - target.max_distances[landmark]);
+		}
+		return static_cast<int>(std::min<uint32_t>(estimate, INT_MAX));
+	}
+};
+
+/**
+ * Notify that the track layout of a tile changed, so the landmarks of the
+ * networks around it are chosen again at their next use.
+ * @param tile The changed tile, or \c INVALID_TILE to choose the landmarks of all networks again.
+ */
+void YapfRailInvalidateLandmarks(TileIndex tile)
+{
+	RailLandmarks::Get().NotifyTrackLayoutChange(tile);
+}
+
+/**
+ * Get the distances of a destination to the landmarks of its rail network.
+ * @param tiles The tiles of the destination.
+ * @return The distances, or an invalid target if nothing is known about the tiles.
+ */
+RailLandmarkTarget YapfRailGetLandmarkTarget(std::span<const TileIndex> tiles)
+{
+	return RailLandmarks::Get().GetTarget(tiles);
+}
+
+/**
+ * Get a lower bound of the cost for a train to get from a tile to a destination.
+ * @param tile The tile.
+ * @param target The distances of the destination to the landmarks.
+ * @return The lower bound.
+ */
+int YapfRailGetLandmarkEstimate(TileIndex tile, const RailLandmarkTarget &target)
+{
+	return RailLandmarks::Get().GetEstimate(tile, target);
+}
@@ -0,0 +1,37 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_rail_landmarks.h Lower bounds of the distances over rail, from the distances to landmarks. */
+
+#ifndef YAPF_RAIL_LANDMARKS_H
+#define YAPF_RAIL_LANDMARKS_H
+
+#include "../../tile_type.h"
+
+/** Maximum number of landmarks of a rail network. */
+static constexpr uint MAX_RAIL_LANDMARKS = 8;
+
+/** The distances of a destination, which might consist of several tiles, to the landmarks of its rail network. */
+struct RailLandmarkTarget {
+	static constexpr uint32_t INVALID_NETWORK = UINT32_MAX; ///< Network of a target without any distances.
+
+	uint32_t network = INVALID_NETWORK; ///< The rail network of all tiles of the target.
+	std::array<uint32_t, MAX_RAIL_LANDMARKS> min_distances{}; ///< Shortest distance from a tile of the target to each landmark.
+	std::array<uint32_t, MAX_RAIL_LANDMARKS> max_distances{}; ///< Longest distance from a tile of the target to each landmark.
+
+	/**
+	 * Check whether distances to the target can be estimated.
+	 * @return True if the target has distances to the landmarks.
+	 */
+	inline bool IsValid() const { return this->network != INVALID_NETWORK; }
+};
+
+void YapfRailInvalidateLandmarks(TileIndex tile);
+RailLandmarkTarget YapfRailGetLandmarkTarget(std::span<const TileIndex> tiles);
+int YapfRailGetLandmarkEstimate(TileIndex tile, const RailLandmarkTarget &target);
+
+#endif /* YAPF_RAIL_LANDMARKS_H */
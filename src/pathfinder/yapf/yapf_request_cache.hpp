@@ -0,0 +1,82 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_request_cache.hpp Caching of the results of path requests. */
+
+#ifndef YAPF_REQUEST_CACHE_HPP
+#define YAPF_REQUEST_CACHE_HPP
+
+/**
+ * Cache of the results of path requests that only depend on the layout of the
+ *  map. Vehicles following the same route ask for the same path over and over,
+ *  so the result of the first request is handed out to the others instead of
+ *  searching again.
+ *
+ * The key has to contain everything the search depends on, apart from the
+ *  layout. The layout is represented by a version that changes whenever the
+ *  layout changes, and the results are forgotten when it does. Searches that
+ *  depend on anything else, such as the occupancy of stations, must not be
+ *  cached; they would not be found the same by a client that just joined.
+ *
+ * @tparam Tkey Key of a request, must be ordered.
+ * @tparam Tresult Result of a request.
+ */
+template <class Tkey, class Tresult>
+class CPathRequestCacheT {
+	static constexpr size_t MAX_RESULTS = 4096; ///< Number of results after which all are forgotten, to bound the memory use.
+
+	std::map<Tkey, Tresult> results; ///< The results of the requests.
+	uint32_t layout_version = 0; ///< The version of the layout the results belong to.
+
+	/**
+	 * Forget the results when they belong to another version of the layout.
+	 * @param layout_version The current version of the layout.
+	 */
+	inline void Validate(uint32_t layout_version)
+	{
+		if (this->layout_version == layout_version) return;
+		this->results.clear();
+		this->layout_version = layout_version;
+	}
+
+public:
+	uint64_t hits = 0; ///< Number of requests that were answered from the cache.
+	uint64_t misses = 0; ///< Number of requests that had to be searched.
+
+	/**
+	 * Find the result of an earlier request.
+	 * @param key The request.
+	 * @param layout_version The current version of the layout.
+	 * @return The result, or \c nullptr if the request was not made with this layout yet.
+	 */
+	inline const Tresult *Find(const Tkey &key, uint32_t layout_version)
+	{
+		this->Validate(layout_version);
+		auto it = this->results.find(key);
+		if (it == this->results.end()) {
+			this->misses++;
+			return nullptr;
+		}
+		this->hits++;
+		return &it->second;
+	}
+
+	/**
+	 * Remember the result of a request.
+	 * @param key The request.
+	 * @param result The result of the search.
+	 * @param layout_version The version of the layout the search was done with.
+	 */
+	inline void Add(const Tkey &key, const Tresult &result, uint32_t layout_version)
+	{
+		this->Validate(layout_version);
+		if (this->results.size() >= MAX_RESULTS) this->results.clear();
+		this->results.insert_or_assign(key, result);
+	}
+};
+
+#endif /* YAPF_REQUEST_CACHE_HPP */
@@ -437,10 +437,14 @@ struct CYapfShip : CYapfT<CYapfShip_TypesT<CYapfShip>> {
 
 Track YapfShipChooseTrack(const Ship *v, TileIndex tile, bool &path_found, ShipPathCache &path_cache)
 {
+	YapfBenchmarkMeasurement measurement(v, tile);
+
 	Trackdir best_origin_dir = INVALID_TRACKDIR;
 	const TrackdirBits origin_dirs = TrackdirToTrackdirBits(v->GetVehicleTrackdir());
 	const Trackdir td_ret = CYapfShip::ChooseShipTrack(v, tile, origin_dirs, TRACKDIR_BIT_NONE, path_found, path_cache, best_origin_dir);
-	return (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : INVALID_TRACK;
+	const Track track = (td_ret != INVALID_TRACKDIR) ? TrackdirToTrack(td_ret) : INVALID_TRACK;
+	measurement.Finish(track, path_found);
+	return track;
 }
 
 bool YapfShipCheckReverse(const Ship *v, Trackdir *trackdir)
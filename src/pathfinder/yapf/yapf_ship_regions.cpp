@@ -23,6 +23,12 @@ static constexpr int MAX_NUMBER_OF_NODES = 65536;
 static constexpr int NODE_LIST_HASH_BITS_OPEN = 12;
 static constexpr int NODE_LIST_HASH_BITS_CLOSED = 12;
 
+/** Request for a path of water region patches: the start patch, the destination station or patch, and the maximum length of the path. */
+using WaterRegionPathRequest = std::tuple<int, int, uint8_t, StationID::BaseType, int, int, uint8_t, int>;
+
+/** Paths of water region patches found with the current layout of the water. */
+static CPathRequestCacheT<WaterRegionPathRequest, std::vector<WaterRegionPatchDesc>> _water_region_path_requests;
+
 /** Yapf Node Key that represents a single patch of interconnected water within a water region. */
 struct WaterRegionPatchKey {
 	WaterRegionPatchDesc water_region_patch;
@@ -233,5 +239,30 @@ public:
  */
 std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(const Ship *v, TileIndex start_tile, int max_returned_path_length)
 {
-	return YapfShipRegions::FindWaterRegionPath(v, start_tile, max_returned_path_length);
+	/* The path only depends on the layout of the water, so ships heading for the same destination share it. */
+	const WaterRegionPatchDesc start = GetWaterRegionPatchInfo(start_tile);
+	StationID station = StationID::Invalid();
+	WaterRegionPatchDesc dest{};
+	if (v->current_order.IsType(OT_GOTO_STATION)) {
+		station = v->current_order.GetDestination().ToStationID();
+	} else {
+		dest = GetWaterRegionPatchInfo(v->dest_tile == INVALID_TILE ? TileIndex{} : v->dest_tile);
+	}
+
+	const WaterRegionPathRequest request{start.x, start.y, start.label.base(), station.base(), dest.x, dest.y, dest.label.base(), max_returned_path_length};
+	const uint32_t layout_version = GetWaterLayoutVersion();
+	if (const std::vector<WaterRegionPatchDesc> *path = _water_region_path_requests.Find(request, layout_version); path != nullptr) return *path;
+
+	std::vector<WaterRegionPatchDesc> path = YapfShipRegions::FindWaterRegionPath(v, start_tile, max_returned_path_length);
+	_water_region_path_requests.Add(request, path, layout_version);
+	return path;
+}
+
+/**
+ * Get how often a path of water regions was taken from the cache, instead of searched.
+ * @return The number of paths taken from the cache and the number of paths searched.
+ */
+std::pair<uint64_t, uint64_t> YapfShipGetWaterRegionPathCacheStatistics()
+{
+	return {_water_region_path_requests.hits, _water_region_path_requests.misses};
 }
@@ -16,5 +16,6 @@
 struct Ship;
 
 std::vector<WaterRegionPatchDesc> YapfShipFindWaterRegionPath(const Ship *v, TileIndex start_tile, int max_returned_path_length);
+std::pair<uint64_t, uint64_t> YapfShipGetWaterRegionPathCacheStatistics();
 
 #endif /* YAPF_SHIP_REGIONS_H */
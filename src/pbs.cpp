@@ -12,6 +12,7 @@
 #include "vehicle_func.h"
 #include "newgrf_station.h"
 #include "pathfinder/follow_track.hpp"
+#include "command_func.h"
 
 #include "safeguards.h"
 
@@ -187,6 +188,38 @@ void UnreserveRailTrack(TileIndex tile, Track t)
 }
 
 
+/** The end of a reservation, as found by following it from some track. */
+struct ReservationIndexEntry {
+	RailTypes rts; ///< The rail types the reservation was followed for.
+	PBSTileInfo end; ///< The end of the reservation.
+	std::vector<std::pair<TileIndex, TrackBits>> reserved; ///< The reserved tracks of every tile that was looked at while following the reservation.
+
+	/**
+	 * Check whether the reservation still ends at the same place, i.e. whether none of the reservations the end depends on changed.
+	 * @return True if the end is still valid.
+	 */
+	bool IsValid() const
+	{
+		return std::ranges::all_of(this->reserved, [](const auto &pair) { return GetReservedTrackbits(pair.first) == pair.second; });
+	}
+};
+
+static const size_t RESERVATION_INDEX_SIZE = 4096; ///< Number of reservation ends to remember before starting over.
+static std::unordered_map<uint64_t, ReservationIndexEntry> _reservation_index; ///< The ends of the reservations followed so far, by where they were followed from.
+
+/**
+ * Get the reserved tracks of a tile, and remember them when the end of a reservation is being recorded.
+ * @param t The tile.
+ * @param entry The entry to remember them in, or \c nullptr.
+ * @return The reserved tracks.
+ */
+static inline TrackBits GetReservedTrackbits(TileIndex t, ReservationIndexEntry *entry)
+{
+	TrackBits reserved = GetReservedTrackbits(t);
+	if (entry != nullptr) entry->reserved.emplace_back(t, reserved);
+	return reserved;
+}
+
 /**
  * Follow a reservation starting from a specific tile to the end.
  * @param o The owner of the track to follow; tracks of other owners are excluded.
@@ -194,9 +227,10 @@ void UnreserveRailTrack(TileIndex tile, Track t)
  * @param tile The start tile.
  * @param trackdir The start trackdir on the tile.
  * @param ignore_oneway Whether one way signals are to be ignored.
+ * @param entry The entry to record the reserved tracks of the tiles the end depends on in, or \c nullptr.
  * @return The end of the path.
  */
-static PBSTileInfo FollowReservation(Owner o, RailTypes rts, TileIndex tile, Trackdir trackdir, bool ignore_oneway = false)
+static PBSTileInfo WalkReservation(Owner o, RailTypes rts, TileIndex tile, Trackdir trackdir, bool ignore_oneway, ReservationIndexEntry *entry)
 {
 	TileIndex start_tile = tile;
 	Trackdir  start_trackdir = trackdir;
@@ -205,12 +239,12 @@ static PBSTileInfo FollowReservation(Owner o, RailTypes rts, TileIndex tile, Tra
 	/* Start track not reserved? This can happen if two trains
 	 * are on the same tile. The reservation on the next tile
 	 * is not ours in this case, so exit. */
-	if (!HasReservedTracks(tile, TrackToTrackBits(TrackdirToTrack(trackdir)))) return PBSTileInfo(tile, trackdir, false);
+	if ((GetReservedTrackbits(tile, entry) & TrackToTrackBits(TrackdirToTrack(trackdir))) == TRACK_BIT_NONE) return PBSTileInfo(tile, trackdir, false);
 
 	/* Do not disallow 90 deg turns as the setting might have changed between reserving and now. */
 	CFollowTrackRail ft(o, rts);
 	while (ft.Follow(tile, trackdir)) {
-		TrackdirBits reserved = ft.new_td_bits & TrackBitsToTrackdirBits(GetReservedTrackbits(ft.new_tile));
+		TrackdirBits reserved = ft.new_td_bits & TrackBitsToTrackdirBits(GetReservedTrackbits(ft.new_tile, entry));
 
 		/* No reservation --> path end found */
 		if (reserved == TRACKDIR_BIT_NONE) {
@@ -219,7 +253,7 @@ static PBSTileInfo FollowReservation(Owner o, RailTypes rts, TileIndex tile, Tra
 				TileIndexDiff diff = TileOffsByDiagDir(ft.exitdir);
 				while (ft.tiles_skipped-- > 0) {
 					ft.new_tile -= diff;
-					if (HasStationReservation(ft.new_tile)) {
+					if (GetReservedTrackbits(ft.new_tile, entry) != TRACK_BIT_NONE) {
 						tile = ft.new_tile;
 						trackdir = DiagDirToDiagTrackdir(ft.exitdir);
 						break;
@@ -260,6 +294,46 @@ static PBSTileInfo FollowReservation(Owner o, RailTypes rts, TileIndex tile, Tra
 	return PBSTileInfo(tile, trackdir, false);
 }
 
+/**
+ * Follow a reservation starting from a specific tile to the end.
+ * The end is remembered in the reservation index, together with the reserved
+ * tracks of the tiles it depends on. As long as those do not change, the end is
+ * taken from the index instead of following the reservation again. The index
+ * is not used while a command runs, as the track layout may change at any
+ * moment during a command.
+ * @param o The owner of the track to follow; tracks of other owners are excluded.
+ * @param rts The rail types to follow the reservation for; rail types not in the mask are excluded.
+ * @param tile The start tile.
+ * @param trackdir The start trackdir on the tile.
+ * @param ignore_oneway Whether one way signals are to be ignored.
+ * @return The end of the path.
+ */
+static PBSTileInfo FollowReservation(Owner o, RailTypes rts, TileIndex tile, Trackdir trackdir, bool ignore_oneway = false)
+{
+	if (RecursiveCommandCounter::IsRunning()) return WalkReservation(o, rts, tile, trackdir, ignore_oneway, nullptr);
+
+	uint64_t key = static_cast<uint64_t>(tile.base()) << 32 | static_cast<uint64_t>(trackdir) << 16 | static_cast<uint64_t>(o.base()) << 8 | (ignore_oneway ? 1 : 0);
+	auto it = _reservation_index.find(key);
+	if (it != _reservation_index.end() && it->second.rts == rts && it->second.IsValid()) return it->second.end;
+
+	if (it == _reservation_index.end()) {
+		if (_reservation_index.size() >= RESERVATION_INDEX_SIZE) _reservation_index.clear();
+		it = _reservation_index.try_emplace(key).first;
+	}
+
+	ReservationIndexEntry &entry = it->second;
+	entry.rts = rts;
+	entry.reserved.clear();
+	entry.end = WalkReservation(o, rts, tile, trackdir, ignore_oneway, &entry);
+	return entry.end;
+}
+
+/** Forget the ends of all reservations, as the track layout might have changed. */
+void InvalidateReservationIndex()
+{
+	_reservation_index.clear();
+}
+
 /**
  * Helper struct for finding the best matching vehicle on a specific track.
  */
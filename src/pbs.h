@@ -47,6 +47,7 @@ bool IsSafeWaitingPosition(const Train *v, TileIndex tile, Trackdir trackdir, bo
 bool IsWaitingPositionFree(const Train *v, TileIndex tile, Trackdir trackdir, bool forbid_90deg = false);
 
 Train *GetTrainForReservation(TileIndex tile, Track track);
+void InvalidateReservationIndex();
 
 /**
  * Check whether some of tracks is reserved on a tile.
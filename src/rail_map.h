@@ -213,6 +213,7 @@ inline void SetTrackReservation(Tile t, TrackBits b)
 	Track track = RemoveFirstTrack(&b);
 	SB(t.m2(), 8, 3, track == INVALID_TRACK ? 0 : track + 1);
 	AssignBit(t.m2(), 11, b != TRACK_BIT_NONE);
+	StateHashMarkTileChanged(t);
 }
 
 /**
@@ -270,6 +271,7 @@ inline void SetDepotReservation(Tile t, bool b)
 {
 	assert(IsRailDepot(t));
 	AssignBit(t.m5(), 4, b);
+	StateHashMarkTileChanged(t);
 }
 
 /**
@@ -411,6 +413,7 @@ inline void SetSignalVariant(Tile t, Track track, SignalVariant v)
 inline void SetSignalStates(Tile tile, uint state)
 {
 	SB(tile.m4(), 4, 4, state);
+	StateHashMarkTileChanged(tile);
 }
 
 /**
@@ -404,6 +404,7 @@ inline void SetCrossingReservation(Tile t, bool b)
 {
 	assert(IsLevelCrossingTile(t));
 	AssignBit(t.m5(), 4, b);
+	StateHashMarkTileChanged(t);
 }
 
 /**
@@ -439,6 +440,7 @@ inline void SetCrossingBarred(Tile t, bool barred)
 {
 	assert(IsLevelCrossing(t));
 	AssignBit(t.m5(), 5, barred);
+	StateHashMarkTileChanged(t);
 }
 
 /**
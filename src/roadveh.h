@@ -99,6 +99,28 @@ struct RoadVehPathElement {
 
 using RoadVehPathCache = std::vector<RoadVehPathElement>;
 
+/** Everything of a road vehicle that decides whether it blocks another road vehicle. */
+struct RoadVehBlockingState {
+	int32_t x_pos = INVALID_COORD; ///< X position of the vehicle.
+	int32_t y_pos = INVALID_COORD; ///< Y position of the vehicle.
+	int32_t z_pos = 0; ///< Z position of the vehicle.
+	Direction direction = INVALID_DIR; ///< Direction the vehicle is facing.
+	bool in_depot = false; ///< Whether the vehicle is in a depot.
+
+	bool operator==(const RoadVehBlockingState &) const = default;
+};
+
+/** The last search for a road vehicle blocking a road vehicle. */
+struct RoadVehBlockingSearch {
+	uint64_t changes = 0; ///< GetRoadVehicleTileHashChanges() when the search was done, or 0 when it was not done.
+	int32_t x = 0; ///< X position searched at.
+	int32_t y = 0; ///< Y position searched at.
+	int32_t z = 0; ///< Z position of the searching vehicle.
+	Direction dir = INVALID_DIR; ///< Direction searched in.
+	VehicleID first = VehicleID::Invalid(); ///< First vehicle of the consist of the searching vehicle.
+	VehicleID blocker = VehicleID::Invalid(); ///< The closest blocking vehicle that was found.
+};
+
 /**
  * Buses, trucks and trams belong to this class.
  */
@@ -112,6 +134,9 @@ struct RoadVehicle final : public GroundVehicle<RoadVehicle, VehicleType::Road>
 	uint16_t crashed_ctr = 0; ///< Animation counter when the vehicle has crashed. @see RoadVehIsCrashed
 	uint8_t reverse_ctr = 0;
 
+	RoadVehBlockingState blocking_state{}; ///< NOSAVE: State of this vehicle when other road vehicles were last told it changed.
+	RoadVehBlockingSearch blocking_search{}; ///< NOSAVE: Last search for a road vehicle blocking this one.
+
 	RoadType roadtype = INVALID_ROADTYPE; ///< NOSAVE: Roadtype of this vehicle.
 	VehicleID disaster_vehicle = VehicleID::Invalid(); ///< NOSAVE: Disaster vehicle targetting this vehicle.
 	RoadTypes compatible_roadtypes{}; ///< NOSAVE: Roadtypes this consist is powered on.
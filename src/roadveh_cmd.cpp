@@ -655,17 +655,42 @@ static void FindClosestBlockingRoadVeh(Vehicle *v, RoadVehFindData *rvf)
 	}
 }
 
-static RoadVehicle *RoadVehFindCloseTo(RoadVehicle *v, int x, int y, Direction dir, bool update_blocked_ctr = true)
+/**
+ * Tell the road vehicles around the parts of a road vehicle when they moved, turned
+ * or entered or left a depot, so they look again whether it blocks them.
+ * @param v The front of the road vehicle.
+ */
+static void UpdateRoadVehBlockingState(RoadVehicle *v)
+{
+	for (RoadVehicle *u = v; u != nullptr; u = u->Next()) {
+		RoadVehBlockingState state{u->x_pos, u->y_pos, u->z_pos, u->direction, u->IsInDepot()};
+		if (state == u->blocking_state) continue;
+
+		u->blocking_state = state;
+		MarkRoadVehicleTileHashChanged(u);
+	}
+}
+
+/**
+ * Find the closest road vehicle blocking a road vehicle.
+ * A road vehicle waiting behind another one does the same search every tick, so
+ * the result is reused for as long as no road vehicle near it changed.
+ * @param v The road vehicle that wants to move.
+ * @param x The X position it wants to move to.
+ * @param y The Y position it wants to move to.
+ * @param dir The direction it wants to move in.
+ * @return The closest blocking road vehicle, or \c nullptr if there is none.
+ */
+static Vehicle *FindBlockingRoadVeh(RoadVehicle *v, int x, int y, Direction dir)
 {
 	RoadVehFindData rvf;
 	RoadVehicle *front = v->First();
 
-	if (front->reverse_ctr != 0) return nullptr;
-
 	rvf.x = x;
 	rvf.y = y;
 	rvf.dir = dir;
 	rvf.veh = v;
+	rvf.best = nullptr;
 	rvf.best_diff = UINT_MAX;
 
 	if (front->state == RVSB_WORMHOLE) {
@@ -675,24 +700,43 @@ static RoadVehicle *RoadVehFindCloseTo(RoadVehicle *v, int x, int y, Direction d
 		for (Vehicle *u : VehiclesOnTile(GetOtherTunnelBridgeEnd(v->tile))) {
 			FindClosestBlockingRoadVeh(u, &rvf);
 		}
-	} else {
-		for (Vehicle *u : VehiclesNearTileXY(x, y, 8)) {
-			FindClosestBlockingRoadVeh(u, &rvf);
-		}
+		return rvf.best;
+	}
+
+	RoadVehBlockingSearch &search = v->blocking_search;
+	if (search.changes != 0 && search.x == x && search.y == y && search.z == v->z_pos && search.dir == dir && search.first == front->index &&
+			!HaveRoadVehiclesNearTileXYChanged(x, y, 8, search.changes)) {
+		return Vehicle::GetIfValid(search.blocker);
+	}
+
+	for (Vehicle *u : VehiclesNearTileXY(x, y, 8)) {
+		FindClosestBlockingRoadVeh(u, &rvf);
 	}
 
+	search = {GetRoadVehicleTileHashChanges(), x, y, v->z_pos, dir, front->index, rvf.best != nullptr ? rvf.best->index : VehicleID::Invalid()};
+	return rvf.best;
+}
+
+static RoadVehicle *RoadVehFindCloseTo(RoadVehicle *v, int x, int y, Direction dir, bool update_blocked_ctr = true)
+{
+	RoadVehicle *front = v->First();
+
+	if (front->reverse_ctr != 0) return nullptr;
+
+	Vehicle *best = FindBlockingRoadVeh(v, x, y, dir);
+
 	/* This code protects a roadvehicle from being blocked for ever
 	 * If more than 1480 / 74 days a road vehicle is blocked, it will
 	 * drive just through it. The ultimate backup-code of TTD.
 	 * It can be disabled. */
-	if (rvf.best_diff == UINT_MAX) {
+	if (best == nullptr) {
 		front->blocked_ctr = 0;
 		return nullptr;
 	}
 
 	if (update_blocked_ctr && ++front->blocked_ctr > 1480) return nullptr;
 
-	return RoadVehicle::From(rvf.best);
+	return RoadVehicle::From(best);
 }
 
 /**
@@ -1667,7 +1711,9 @@ bool RoadVehicle::Tick()
 
 	if (this->IsFrontEngine()) {
 		if (!this->vehstatus.Test(VehState::Stopped)) this->running_ticks++;
-		return RoadVehController(this);
+		if (!RoadVehController(this)) return false;
+		UpdateRoadVehBlockingState(this);
+		return true;
 	}
 
 	return true;
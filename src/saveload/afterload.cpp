@@ -32,6 +32,9 @@
 #include "../roadstop_base.h"
 #include "../tunnelbridge_map.h"
 #include "../pathfinder/yapf/yapf_cache.h"
+#include "../pathfinder/water_regions.h"
+#include "../signal_func.h"
+#include "../pbs.h"
 #include "../elrail_func.h"
 #include "../signs_func.h"
 #include "../aircraft.h"
@@ -1440,6 +1443,8 @@ bool AfterLoadGame()
 	}
 
 	YapfNotifyTrackLayoutChange(INVALID_TILE, INVALID_TRACK);
+	InvalidateSignalBlockCache();
+	InvalidateReservationIndex();
 
 	if (IsSavegameVersionBefore(SLV_34)) {
 		for (Company *c : Company::Iterate()) ResetCompanyLivery(c);
@@ -3439,6 +3444,9 @@ bool AfterLoadGame()
 
 	AfterLoadLinkGraphs();
 
+	/* Update all water regions now, instead of when the first ships need them. */
+	UpdateAllInvalidWaterRegions();
+
 	CheckGroundVehiclesAtCorrectZ();
 
 	/* Start the scripts. This MUST happen after everything else except
@@ -139,6 +139,7 @@ SaveLoadTable GetLinkGraphDesc()
 		 SLE_VAR(LinkGraph, last_compression, SLE_INT32),
 		SLEG_CONDVAR("num_nodes", _num_nodes, SLE_UINT16, SL_MIN_VERSION, SLV_SAVELOAD_LIST_LENGTH),
 		 SLE_VAR(LinkGraph, cargo,            SLE_UINT8),
+		SLE_CONDVAR(LinkGraph, incremental_runs, SLE_UINT8, SLV_LINKGRAPH_INCREMENTAL, SL_MAX_VERSION),
 		SLEG_STRUCTLIST("nodes", SlLinkgraphNode),
 	};
 	return link_graph_desc;
@@ -168,6 +169,19 @@ public:
 	}
 };
 
+/** Save/load the flows of the previous job, which a link graph job reuses. */
+class SlLinkgraphJobPreviousFlow : public VectorSaveLoadHandler<SlLinkgraphJobPreviousFlow, LinkGraphJob, LinkGraphJob::PreviousFlow> {
+public:
+	static inline const SaveLoad description[] = {
+		SLE_VAR(LinkGraphJob::PreviousFlow, node,   SLE_UINT16),
+		SLE_VAR(LinkGraphJob::PreviousFlow, origin, SLE_UINT16),
+		SLE_VAR(LinkGraphJob::PreviousFlow, via,    SLE_UINT16),
+	};
+	static inline const SaveLoadCompatTable compat_description = {};
+
+	std::vector<LinkGraphJob::PreviousFlow> &GetVector(LinkGraphJob *lgj) const override { return lgj->previous_flows; }
+};
+
 /**
  * Get a SaveLoad array for a link graph job. The settings struct is derived from
  * the global settings saveload array. The exact entries are calculated when the function
@@ -185,6 +199,7 @@ SaveLoadTable GetLinkGraphJobDesc()
 		SLE_VAR(LinkGraphJob, join_date,        SLE_INT32),
 		SLE_VAR(LinkGraphJob, link_graph.index, SLE_UINT16),
 		SLEG_STRUCT("linkgraph", SlLinkgraphJobProxy),
+		SLEG_CONDSTRUCTLIST("previous_flows", SlLinkgraphJobPreviousFlow, SLV_LINKGRAPH_INCREMENTAL, SL_MAX_VERSION),
 	};
 
 	/* The member offset arithmetic below is only valid if the types in question
@@ -416,6 +416,8 @@ enum SaveLoadVersion : uint16_t {
 	SLV_BUOYS_AT_0_0,                       ///< 364  PR#14983 Allow to build buoys at (0x0).
 
 	SLV_DRIVE_BACKWARDS,                    ///< 365  PR#15379 Trains can drive backwards.
+	SLV_LINKGRAPH_INCREMENTAL,              ///< 366  Link graph jobs can reuse the flows of the previous job.
+	SLV_RAIL_LANDMARKS,                     ///< 367  Optional landmark heuristic for the rail pathfinder.
 
 	SL_MAX_VERSION,                         ///< Highest possible saveload version
 };
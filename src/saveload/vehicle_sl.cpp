@@ -560,7 +560,6 @@ void AfterLoadVehiclesPhase2(bool part_of_load)
 	}
 }
 
-bool TrainController(Train *v, Vehicle *nomove, bool reverse = true); // From train_cmd.cpp
 void ReverseTrainSwapVeh(Train *v, int l, int r);
 
 /** Fixup old train spacing. */
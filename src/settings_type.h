@@ -371,6 +371,7 @@ struct NewsSettings {
 /** All settings related to the network. */
 struct NetworkSettings {
 	uint16_t sync_freq; ///< how often do we check whether we are still in-sync
+	bool sync_state_hash; ///< let clients report hashes of the game state, to find where a desync started
 	uint8_t frame_freq; ///< how often do we send commands to the clients
 	uint16_t commands_per_frame; ///< how many commands may be sent each frame_freq frames?
 	uint16_t commands_per_frame_server; ///< how many commands may be sent each frame_freq frames? (server-originating commands)
@@ -386,6 +387,7 @@ struct NetworkSettings {
 	uint16_t server_port; ///< port the server listens on
 	uint16_t server_admin_port; ///< port the server listens on for the admin network
 	bool server_admin_chat; ///< allow private chat for the server to be distributed to the admin network
+	uint16_t admin_telemetry_rate; ///< maximum amount of vehicle, station and link graph updates to send to each admin, in KiB per second
 	ServerGameType server_game_type; ///< Server type: local / public / invite-only.
 	std::string server_invite_code; ///< Invite code to use when registering as server.
 	std::string server_invite_code_secret; ///< Secret to proof we got this invite code from the Game Coordinator.
@@ -527,6 +529,7 @@ struct YAPFSettings {
 	uint32_t rail_longer_platform_per_tile_penalty; ///< penalty for longer station platform than train (per tile)
 	uint32_t rail_shorter_platform_penalty; ///< penalty for shorter station platform than train
 	uint32_t rail_shorter_platform_per_tile_penalty; ///< penalty for shorter station platform than train (per tile)
+	bool rail_landmarks; ///< estimate the remaining cost of rail paths using the distances to landmarks
 	uint32_t ship_curve45_penalty; ///< penalty for 45-deg curve for ships
 	uint32_t ship_curve90_penalty; ///< penalty for 90-deg curve for ships
 };
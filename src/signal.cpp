@@ -16,6 +16,7 @@
 #include "train.h"
 #include "company_base.h"
 #include "pbs.h"
+#include "command_func.h"
 
 #include "table/signal_data.h"
 
@@ -27,6 +28,7 @@ static const uint SIG_TBU_SIZE    =  64; ///< number of signals entering to bloc
 static const uint SIG_TBD_SIZE    = 256; ///< number of intersections - open nodes in current block
 static const uint SIG_GLOB_SIZE   = 128; ///< number of open blocks (block can be opened more times until detected)
 static const uint SIG_GLOB_UPDATE =  64; ///< how many items need to be in _globset to force update
+static const uint SIG_BLOCK_CACHE_SIZE = 4096; ///< number of signal blocks to remember before starting over
 
 static_assert(SIG_GLOB_UPDATE <= SIG_GLOB_SIZE);
 
@@ -264,6 +266,69 @@ enum class SigFlag : uint8_t {
 };
 using SigFlags = EnumBitSet<SigFlag, uint16_t>;
 
+/** The flags of a signal block that only depend on its track layout. */
+static constexpr SigFlags SIG_BLOCK_LAYOUT_FLAGS{SigFlag::Pbs, SigFlag::Split, SigFlag::Enter, SigFlag::MultiEnter};
+
+/**
+ * The track layout of a signal block, as found by exploring it from one place.
+ * It contains everything the exploration finds, except for the trains and the
+ * states of the pre-signal exits. Those are checked again each time the block
+ * is updated, without walking the tracks.
+ */
+struct SignalBlock {
+	SigFlags flags{}; ///< The flags that only depend on the track layout.
+	std::vector<std::pair<TileIndex, TrackBits>> probes; ///< Track pieces to check for trains, TRACK_BIT_NONE for the whole tile.
+	std::vector<std::pair<TileIndex, Trackdir>> exits; ///< Pre-signal exits in the direction leaving the block.
+	std::vector<std::pair<TileIndex, Trackdir>> signals; ///< Signals entering the block, in the order they are updated.
+	std::vector<std::pair<TileIndex, DiagDirection>> sides; ///< Tile sides passed while exploring, in the order they were removed from _globset.
+
+	SigFlags Apply() const;
+};
+
+static SignalBlock *_recording_block = nullptr; ///< The signal block the exploration is recorded in, if any.
+static std::unordered_map<uint64_t, SignalBlock> _signal_blocks; ///< The signal blocks found so far, by the place they were explored from.
+
+/**
+ * Check whether there is a train on some tracks of a tile.
+ * @param tile The tile to check.
+ * @param tracks The tracks to check, or TRACK_BIT_NONE for any train on the tile that is not in a depot.
+ * @return \c true when there is a train.
+ */
+static bool HasTrainOnTracks(TileIndex tile, TrackBits tracks)
+{
+	if (tracks == TRACK_BIT_NONE) return HasVehicleOnTile(tile, IsTrainAndNotInDepot);
+	return EnsureNoTrainOnTrackBits(tile, tracks).Failed();
+}
+
+/**
+ * Check for a train on some tracks of a tile, unless a train was found in the segment already.
+ * @param[in,out] flags The flags of the segment.
+ * @param tile The tile to check.
+ * @param tracks The tracks to check, or TRACK_BIT_NONE for any train on the tile that is not in a depot.
+ */
+static inline void CheckTrainOnTracks(SigFlags &flags, TileIndex tile, TrackBits tracks)
+{
+	if (_recording_block != nullptr) _recording_block->probes.emplace_back(tile, tracks);
+
+	/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
+	if (!flags.Test(SigFlag::Train) && HasTrainOnTracks(tile, tracks)) flags.Set(SigFlag::Train);
+}
+
+/**
+ * Record the tile sides removed from _globset when adding to the Todo set.
+ * @see CheckAddToTodoSet
+ * @param t1 tile we are entering
+ * @param d1 direction (tile side) we are entering
+ * @param t2 tile we are leaving
+ * @param d2 direction (tile side) we are leaving
+ */
+static inline void RecordSides(TileIndex t1, DiagDirection d1, TileIndex t2, DiagDirection d2)
+{
+	if (_recording_block == nullptr) return;
+	_recording_block->sides.emplace_back(t1, d1);
+	_recording_block->sides.emplace_back(t2, d2);
+}
+
 /**
  * Search signal block
  *
@@ -287,13 +352,13 @@ static SigFlags ExploreSegment(Owner owner)
 
 				if (IsRailDepot(tile)) {
 					if (enterdir == INVALID_DIAGDIR) { // from 'inside' - train just entered or left the depot
-						if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+						CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 						exitdir = GetRailDepotDirection(tile);
 						tile += TileOffsByDiagDir(exitdir);
 						enterdir = ReverseDiagDir(exitdir);
 						break;
 					} else if (enterdir == GetRailDepotDirection(tile)) { // entered a depot
-						if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+						CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 						continue;
 					} else {
 						continue;
@@ -306,11 +371,10 @@ static SigFlags ExploreSegment(Owner owner)
 
 				if (tracks == TRACK_BIT_HORZ || tracks == TRACK_BIT_VERT) { // there is exactly one incidating track, no need to check
 					tracks = tracks_masked;
-					/* If no train detected yet, and there is not no train -> there is a train -> set the flag */
-					if (!flags.Test(SigFlag::Train) && EnsureNoTrainOnTrackBits(tile, tracks).Failed()) flags. Set(SigFlag::Train);
+					CheckTrainOnTracks(flags, tile, tracks);
 				} else {
 					if (tracks_masked == TRACK_BIT_NONE) continue; // no incidating track
-					if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+					CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 				}
 
 				/* Is this a track merge or split? */
@@ -331,9 +395,12 @@ static SigFlags ExploreSegment(Owner owner)
 							flags.Set(SigFlag::Enter);
 
 							if (!_tbuset.Add(tile, reversedir)) return flags | SigFlag::Full;
+							if (_recording_block != nullptr) _recording_block->signals.emplace_back(tile, reversedir);
 						}
 						if (HasSignalOnTrackdir(tile, trackdir) && !IsOnewaySignal(tile, track)) flags.Set(SigFlag::Pbs);
 
+						if (_recording_block != nullptr && IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) _recording_block->exits.emplace_back(tile, trackdir);
+
 						/* if it is a presignal EXIT in OUR direction and we haven't found 2 green exits yes, do special check */
 						if (!flags.Test(SigFlag::MultiGreen) && IsPresignalExit(tile, track) && HasSignalOnTrackdir(tile, trackdir)) { // found presignal exit
 							if (flags.Test(SigFlag::Exit)) flags.Set(SigFlag::MultiExit); // found two (or more) exits
@@ -352,6 +419,7 @@ static SigFlags ExploreSegment(Owner owner)
 					if (dir != enterdir && (tracks & _enterdir_to_trackbits[dir])) { // any track incidating?
 						TileIndex newtile = tile + TileOffsByDiagDir(dir);  // new tile to check
 						DiagDirection newdir = ReverseDiagDir(dir); // direction we are entering from
+						RecordSides(newtile, newdir, tile, dir);
 						if (!MaybeAddToTodoSet(newtile, newdir, tile, dir)) return flags | SigFlag::Full;
 					}
 				}
@@ -365,7 +433,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (DiagDirToAxis(enterdir) != GetRailStationAxis(tile)) continue; // different axis
 				if (IsStationTileBlocked(tile)) continue; // 'eye-candy' station tile
 
-				if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+				CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -374,7 +442,7 @@ static SigFlags ExploreSegment(Owner owner)
 				if (GetTileOwner(tile) != owner) continue;
 				if (DiagDirToAxis(enterdir) == GetCrossingRoadAxis(tile)) continue; // different axis
 
-				if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+				CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 				tile += TileOffsByDiagDir(exitdir);
 				break;
 
@@ -384,13 +452,13 @@ static SigFlags ExploreSegment(Owner owner)
 				DiagDirection dir = GetTunnelBridgeDirection(tile);
 
 				if (enterdir == INVALID_DIAGDIR) { // incoming from the wormhole
-					if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+					CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 					enterdir = dir;
 					exitdir = ReverseDiagDir(dir);
 					tile += TileOffsByDiagDir(exitdir); // just skip to next tile
 				} else { // NOT incoming from the wormhole!
 					if (ReverseDiagDir(enterdir) != dir) continue;
-					if (!flags.Test(SigFlag::Train) && HasVehicleOnTile(tile, IsTrainAndNotInDepot)) flags.Set(SigFlag::Train);
+					CheckTrainOnTracks(flags, tile, TRACK_BIT_NONE);
 					tile = GetOtherTunnelBridgeEnd(tile); // just skip to exit tile
 					enterdir = INVALID_DIAGDIR;
 					exitdir = INVALID_DIAGDIR;
@@ -402,6 +470,7 @@ static SigFlags ExploreSegment(Owner owner)
 				continue; // continue the while() loop
 		}
 
+		RecordSides(tile, enterdir, oldtile, exitdir);
 		if (!MaybeAddToTodoSet(tile, enterdir, oldtile, exitdir)) return flags | SigFlag::Full;
 	}
 
@@ -409,6 +478,82 @@ static SigFlags ExploreSegment(Owner owner)
 }
 
 
+/**
+ * Redo the exploration of the signal block, without walking its tracks.
+ * Only the trains and the pre-signal exits are checked again.
+ * @return SigFlags
+ */
+SigFlags SignalBlock::Apply() const
+{
+	for (const auto &[tile, side] : this->sides) _globset.Remove(tile, side);
+
+	SigFlags flags = this->flags;
+	for (const auto &[tile, tracks] : this->probes) {
+		if (HasTrainOnTracks(tile, tracks)) {
+			flags.Set(SigFlag::Train);
+			break;
+		}
+	}
+
+	for (const auto &[tile, trackdir] : this->exits) {
+		if (flags.Test(SigFlag::Exit)) flags.Set(SigFlag::MultiExit);
+		flags.Set(SigFlag::Exit);
+		if (GetSignalStateByTrackdir(tile, trackdir) == SIGNAL_STATE_GREEN) {
+			if (flags.Test(SigFlag::Green)) flags.Set(SigFlag::MultiGreen);
+			flags.Set(SigFlag::Green);
+		}
+	}
+
+	for (const auto &[tile, trackdir] : this->signals) _tbuset.Add(tile, trackdir);
+
+	return flags;
+}
+
+
+/**
+ * Search signal block, or reuse what an earlier search of the same block found.
+ * The blocks are only reused outside of commands, as the track layout may
+ * change at any moment during a command.
+ *
+ * @param tile tile the search was started from
+ * @param dir direction (tile side) the search was started from
+ * @param owner owner whose signals we are updating
+ * @return SigFlags
+ */
+static SigFlags ExploreSegment(TileIndex tile, DiagDirection dir, Owner owner)
+{
+	if (RecursiveCommandCounter::IsRunning()) return ExploreSegment(owner);
+
+	uint64_t key = static_cast<uint64_t>(tile.base()) << 16 | static_cast<uint64_t>(dir) << 8 | owner.base();
+	auto it = _signal_blocks.find(key);
+	if (it != _signal_blocks.end()) {
+		_tbdset.Reset();
+		return it->second.Apply();
+	}
+
+	SignalBlock block;
+	_recording_block = &block;
+	SigFlags flags = ExploreSegment(owner);
+	_recording_block = nullptr;
+
+	/* A block that could not be explored completely is explored again next time. */
+	if (!flags.Test(SigFlag::Full)) {
+		if (_signal_blocks.size() >= SIG_BLOCK_CACHE_SIZE) _signal_blocks.clear();
+		block.flags = flags & SIG_BLOCK_LAYOUT_FLAGS;
+		_signal_blocks.emplace(key, std::move(block));
+	}
+
+	return flags;
+}
+
+
+/** Forget the signal blocks found so far, as the track layout might have changed. */
+void InvalidateSignalBlockCache()
+{
+	_signal_blocks.clear();
+}
+
+
 /**
  * Update signals around segment in _tbuset
  *
@@ -497,6 +642,9 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(_tbuset.IsEmpty());
 		assert(_tbdset.IsEmpty());
 
+		TileIndex start_tile = tile;
+		DiagDirection start_dir = dir;
+
 		/* After updating signal, data stored are always TileType::Railway with signals.
 		 * Other situations happen when data are from outside functions -
 		 * modification of railbits (including both rail building and removal),
@@ -545,7 +693,7 @@ static SigSegState UpdateSignalsInBuffer(Owner owner)
 		assert(!_tbdset.Overflowed()); // it really shouldn't overflow by these one or two items
 		assert(!_tbdset.IsEmpty()); // it wouldn't hurt anyone, but shouldn't happen too
 
-		SigFlags flags = ExploreSegment(owner);
+		SigFlags flags = ExploreSegment(start_tile, start_dir, owner);
 
 		if (first) {
 			first = false;
@@ -19,6 +19,7 @@
 #include "vehicle_base.h"
 #include "base_media_func.h"
 #include "base_media_sounds.h"
+#include "network/network.h"
 
 #include "safeguards.h"
 
@@ -224,6 +225,9 @@ static void SndPlayScreenCoordFx(SoundID sound, int left, int right, int top, in
 
 void SndPlayTileFx(SoundID sound, TileIndex tile)
 {
+	/* Nobody hears the sounds of frames that are run while catching up with the server. */
+	if (_network_catching_up) return;
+
 	/* emits sound from center of the tile */
 	int x = std::min(Map::MaxX() - 1, TileX(tile)) * TILE_SIZE + TILE_SIZE / 2;
 	int y = std::min(Map::MaxY() - 1, TileY(tile)) * TILE_SIZE - TILE_SIZE / 2;
@@ -236,6 +240,8 @@ void SndPlayTileFx(SoundID sound, TileIndex tile)
 
 void SndPlayVehicleFx(SoundID sound, const Vehicle *v)
 {
+	if (_network_catching_up) return;
+
 	SndPlayScreenCoordFx(sound,
 		v->coord.left, v->coord.right,
 		v->coord.top, v->coord.bottom
@@ -372,6 +372,7 @@ struct Airport : public TileArea {
 	Airport() : TileArea(INVALID_TILE, 0, 0) {}
 
 	AirportBlocks blocks{}; ///< stores which blocks on the airport are taken. was 16 bit earlier on, then 32
+	std::vector<VehicleID> block_waiters{}; ///< Aircraft waiting for blocks to be released, see #WakeAircraftWaitingForBlocks. Not saved.
 	uint8_t type = 0; ///< Type of this airport, @see AirportTypes
 	uint8_t layout = 0; ///< Airport layout number.
 	Direction rotation = INVALID_DIR; ///< How this airport is rotated.
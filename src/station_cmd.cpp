@@ -26,6 +26,7 @@
 #include "newgrf_station.h"
 #include "newgrf_canal.h" /* For the buoy */
 #include "pathfinder/yapf/yapf_cache.h"
+#include "pathfinder/water_regions.h"
 #include "road_internal.h" /* For drawing catenary/checking road removal */
 #include "autoslope.h"
 #include "water.h"
@@ -2736,6 +2737,7 @@ CommandCost CmdBuildAirport(DoCommandFlags flags, TileIndex tile, uint8_t airpor
 		st->airport.layout = layout;
 		st->airport.blocks = {};
 		st->airport.rotation = rotation;
+		WakeAircraftWaitingForBlocks(st);
 
 		st->rect.BeforeAddRect(tile, w, h, StationRect::ADD_TRY);
 
@@ -2835,6 +2837,7 @@ static CommandCost RemoveAirport(TileIndex tile, DoCommandFlags flags)
 
 		st->airport.Clear();
 		st->facilities.Reset(StationFacility::Airport);
+		WakeAircraftWaitingForBlocks(st);
 		SetWindowClassesDirty(WC_VEHICLE_ORDERS);
 
 		InvalidateWindowData(WC_STATION_VIEW, st->index, -1);
@@ -2867,6 +2870,7 @@ CommandCost CmdOpenCloseAirport(DoCommandFlags flags, StationID station_id)
 
 	if (flags.Test(DoCommandFlag::Execute)) {
 		st->airport.blocks.Flip(AirportBlock::AirportClosed);
+		WakeAircraftWaitingForBlocks(st);
 		SetWindowWidgetDirty(WC_STATION_VIEW, st->index, WID_SV_CLOSE_AIRPORT);
 	}
 	return CommandCost();
@@ -4708,6 +4712,7 @@ uint MoveGoodsToStation(CargoType cargo, uint amount, Source source, const Stati
 void UpdateStationDockingTiles(Station *st)
 {
 	st->docking_station.Clear();
+	NotifyDockingTilesChange();
 
 	/* For neutral stations, start with the industry area instead of dock area */
 	const TileArea *area = st->industry != nullptr ? &st->industry->location : &st->ship_station;
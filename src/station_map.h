@@ -572,6 +572,7 @@ inline void SetRailStationReservation(Tile t, bool b)
 {
 	assert(HasStationRail(t));
 	AssignBit(t.m6(), 2, b);
+	StateHashMarkTileChanged(t);
 }
 
 /**
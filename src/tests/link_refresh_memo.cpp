@@ -0,0 +1,66 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file link_refresh_memo.cpp Test that memoised link refresh walks are forgotten when they become invalid. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../linkgraph/refresh.h"
+
+#include "../safeguards.h"
+
+/**
+ * Make a list of orders going to the given stations.
+ * @param stations The stations to go to.
+ * @return The orders.
+ */
+static std::vector<Order> MakeOrders(std::initializer_list<uint16_t> stations)
+{
+	std::vector<Order> orders;
+	for (uint16_t station : stations) orders.emplace_back().MakeGoToStation(StationID{station});
+	return orders;
+}
+
+TEST_CASE("LinkRefresher memo invalidation")
+{
+	LinkRefresher::ResetMemos();
+
+	REQUIRE(OrderList::CanAllocateItem());
+	OrderList *order_list = OrderList::Create();
+	OrderListID index = order_list->index;
+	std::vector<Order> orders = MakeOrders({1, 2, 3});
+
+	LinkRefresher::GetMemo(index, orders).traversals.emplace_back(0, true);
+	CHECK(LinkRefresher::GetMemo(index, orders).traversals.size() == 1);
+
+	SECTION("Changed orders") {
+		std::vector<Order> changed = MakeOrders({1, 3, 2});
+		CHECK(LinkRefresher::GetMemo(index, changed).traversals.empty());
+	}
+
+	SECTION("Deleted order list") {
+		delete order_list;
+		order_list = nullptr;
+
+		/* A new order list with the same orders, that gets the same index. */
+		REQUIRE(OrderList::CanAllocateItem());
+		OrderList *reused = OrderList::Create();
+		CHECK(reused->index == index);
+		CHECK(LinkRefresher::GetMemo(index, orders).traversals.empty());
+		delete reused;
+	}
+
+	SECTION("New game") {
+		LinkRefresher::ResetMemos();
+		CHECK(LinkRefresher::GetMemo(index, orders).traversals.empty());
+	}
+
+	delete order_list;
+	LinkRefresher::ResetMemos();
+}
@@ -0,0 +1,147 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file linkgraph_incremental.cpp Test the quality of link graph jobs that reuse the flows of the previous job. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../settings_type.h"
+#include "../linkgraph/linkgraphjob.h"
+#include "../linkgraph/linkgraphschedule.h"
+
+#include <random>
+
+#include "../safeguards.h"
+
+/** Number of nodes of the generated link graph. */
+static const uint TEST_NODES = 100;
+
+/**
+ * Generate a link graph with the stations on a grid, each linked to its neighbours.
+ * @param lg The link graph to fill.
+ */
+static void GenerateLinkGraph(LinkGraph &lg)
+{
+	std::mt19937 random(TEST_NODES);
+	uint width = IntSqrt(TEST_NODES);
+
+	lg.Init(TEST_NODES);
+	for (NodeID i = 0; i < TEST_NODES; i++) {
+		LinkGraph::BaseNode &node = lg[i];
+		node.station = StationID(i);
+		node.xy = TileXY(1 + (i % width) * 20 + random() % 10, 1 + (i / width) * 20 + random() % 10);
+		node.supply = 10 + random() % 100;
+		node.demand = 1;
+	}
+
+	auto link = [&](NodeID from, NodeID to) {
+		uint capacity = 100 + random() % 400;
+		uint32_t travel_time = DistanceManhattan(lg[from].xy, lg[to].xy) * 30;
+		lg[from].AddEdge(to, capacity, 0, travel_time, EdgeUpdateMode::Unrestricted);
+		lg[to].AddEdge(from, capacity, 0, travel_time, EdgeUpdateMode::Unrestricted);
+	};
+	for (NodeID i = 0; i < TEST_NODES; i++) {
+		if (i % width != width - 1) link(i, i + 1);
+		if (i + width < TEST_NODES) link(i, i + width);
+	}
+}
+
+/**
+ * Change the capacity of every link by a factor.
+ * @param lg The link graph to change.
+ * @param percent The new capacity, in percent of the old one.
+ */
+static void ScaleCapacities(LinkGraph &lg, uint percent)
+{
+	for (NodeID i = 0; i < lg.Size(); i++) {
+		for (LinkGraph::BaseEdge &edge : lg[i].edges) edge.capacity = std::max(1U, edge.capacity * percent / 100);
+	}
+}
+
+/** Measures of the quality of the flows of a job. */
+struct FlowQuality {
+	uint64_t demand = 0; ///< Total demand between all nodes.
+	uint64_t satisfied = 0; ///< Demand that got assigned to flows.
+	uint64_t cost = 0; ///< Sum over the links of the flow times the distance.
+	uint64_t overload = 0; ///< Sum over the links of the flow exceeding the capacity.
+};
+
+/**
+ * Measure the quality of the flows of a finished job.
+ * @param job The job.
+ * @return The quality.
+ */
+static FlowQuality MeasureFlows(LinkGraphJob &job)
+{
+	FlowQuality quality;
+	for (NodeID from = 0; from < job.Size(); from++) {
+		for (NodeID to = 0; to < job.Size(); to++) {
+			quality.demand += job[from].DemandTo(to);
+			quality.satisfied += job[from].DemandTo(to) - job[from].UnsatisfiedDemandTo(to);
+		}
+		for (const auto edge : job[from].Edges()) {
+			quality.cost += static_cast<uint64_t>(edge.Flow()) * DistanceManhattan(job[from].base.xy, job[edge.DestNode()].base.xy);
+			if (edge.Flow() > edge.Capacity()) quality.overload += edge.Flow() - edge.Capacity();
+		}
+	}
+	return quality;
+}
+
+TEST_CASE("LinkGraph incremental recalculation")
+{
+	Map::Allocate(256, 256);
+
+	_settings_game.linkgraph.distribution_default = DistributionType::Symmetric;
+	_settings_game.linkgraph.accuracy = 16;
+	_settings_game.linkgraph.demand_size = 100;
+	_settings_game.linkgraph.demand_distance = 100;
+	_settings_game.linkgraph.short_path_saturation = 80;
+
+	LinkGraph lg(LinkGraphID::Begin(), CargoType{0});
+	GenerateLinkGraph(lg);
+
+	LinkGraphJob previous(LinkGraphJobID::Begin(), lg);
+	LinkGraphSchedule::Run(&previous);
+	REQUIRE(previous.IsJobCompleted());
+	REQUIRE_FALSE(previous.IsIncremental());
+	auto previous_flows = [&](NodeID node) { return &previous[node].flows; };
+
+	SECTION("Small changes reuse the previous flows")
+	{
+		ScaleCapacities(lg, 110);
+
+		LinkGraphJob incremental(LinkGraphJobID::Begin(), lg);
+		incremental.SetPreviousFlows(previous_flows);
+		LinkGraphSchedule::Run(&incremental);
+		REQUIRE(incremental.IsIncremental());
+
+		LinkGraphJob full(LinkGraphJobID::Begin(), lg);
+		LinkGraphSchedule::Run(&full);
+		REQUIRE_FALSE(full.IsIncremental());
+
+		FlowQuality incremental_quality = MeasureFlows(incremental);
+		FlowQuality full_quality = MeasureFlows(full);
+		CHECK(incremental_quality.demand == full_quality.demand);
+		CHECK(incremental_quality.satisfied == full_quality.satisfied);
+		/* The reused routes may be a bit longer and more loaded than fresh ones. */
+		CHECK(incremental_quality.cost <= full_quality.cost * 110 / 100);
+		CHECK(incremental_quality.overload <= full_quality.overload + full_quality.satisfied / 10);
+	}
+
+	SECTION("Large changes fall back to a full recalculation")
+	{
+		ScaleCapacities(lg, 10);
+
+		LinkGraphJob job(LinkGraphJobID::Begin(), lg);
+		job.SetPreviousFlows(previous_flows);
+		LinkGraphSchedule::Run(&job);
+		CHECK_FALSE(job.IsIncremental());
+	}
+}
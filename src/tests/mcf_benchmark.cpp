@@ -0,0 +1,114 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/**
+ * @file mcf_benchmark.cpp Benchmark of the multi-commodity flow solver on generated link graphs.
+ *
+ * The benchmark is hidden, so it does not slow down the normal test runs.
+ * Run it with: openttd_test "[mcf-benchmark]"
+ */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../settings_type.h"
+#include "../linkgraph/demands.h"
+#include "../linkgraph/flowmapper.h"
+#include "../linkgraph/mcf.h"
+
+#include <chrono>
+#include <random>
+
+#include "../safeguards.h"
+
+/**
+ * Generate a link graph that looks like a large rail network: the stations
+ * are spread over a grid, each linked to its neighbours in both directions,
+ * with some long distance links in between. A quarter of the stations
+ * accepts the cargo.
+ * @param lg The link graph to fill.
+ * @param size The number of nodes.
+ */
+static void GenerateLinkGraph(LinkGraph &lg, uint size)
+{
+	std::mt19937 random(size);
+	uint width = std::max(1U, IntSqrt(size));
+	uint spacing = std::max(1U, (Map::MaxX() - 2) / width);
+
+	lg.Init(size);
+	for (NodeID i = 0; i < size; i++) {
+		LinkGraph::BaseNode &node = lg[i];
+		node.station = StationID(i);
+		node.xy = TileXY(1 + (i % width) * spacing + random() % spacing, 1 + (i / width) * spacing + random() % spacing);
+		node.supply = 10 + random() % 100;
+		node.demand = random() % 4 == 0 ? 1 : 0;
+	}
+
+	auto link = [&](NodeID from, NodeID to) {
+		if (from == to || lg[from].HasEdgeTo(to)) return;
+		uint capacity = 100 + random() % 2000;
+		uint32_t travel_time = DistanceManhattan(lg[from].xy, lg[to].xy) * 30;
+		lg[from].AddEdge(to, capacity, random() % capacity, travel_time, EdgeUpdateMode::Unrestricted);
+		lg[to].AddEdge(from, capacity, random() % capacity, travel_time, EdgeUpdateMode::Unrestricted);
+	};
+	for (NodeID i = 0; i < size; i++) {
+		if (i % width != width - 1 && i + 1U < size) link(i, i + 1);
+		if (i + width < size) link(i, i + width);
+		if (random() % 8 == 0) link(i, random() % size);
+	}
+}
+
+/**
+ * Run the demand calculation and both MCF passes on a generated link graph.
+ * @param size The number of nodes.
+ */
+static void BenchmarkMCF(uint size)
+{
+	LinkGraph lg(LinkGraphID::Begin(), CargoType{0});
+	GenerateLinkGraph(lg, size);
+
+	LinkGraphJob job(LinkGraphJobID::Begin(), lg);
+	job.Init();
+	DemandHandler().Run(job);
+
+	auto start = std::chrono::steady_clock::now();
+	MCFHandler<MCF1stPass>().Run(job);
+	auto first_pass = std::chrono::steady_clock::now();
+	FlowMapper(false).Run(job);
+	auto mapped = std::chrono::steady_clock::now();
+	MCFHandler<MCF2ndPass>().Run(job);
+	auto second_pass = std::chrono::steady_clock::now();
+
+	uint64_t flow = 0;
+	for (NodeID i = 0; i < size; i++) {
+		for (const auto edge : job[i].Edges()) flow += edge.Flow();
+	}
+	CHECK(flow > 0);
+
+	using ms = std::chrono::milliseconds;
+	WARN(fmt::format("MCF on {} nodes: 1st pass {} ms, 2nd pass {} ms, total flow {}", size,
+			std::chrono::duration_cast<ms>(first_pass - start).count(),
+			std::chrono::duration_cast<ms>(second_pass - mapped).count(), flow));
+}
+
+TEST_CASE("MCF benchmark", "[.][mcf-benchmark]")
+{
+	Map::Allocate(1024, 1024);
+
+	_settings_game.linkgraph.distribution_default = DistributionType::Symmetric;
+	_settings_game.linkgraph.accuracy = 16;
+	_settings_game.linkgraph.demand_size = 100;
+	_settings_game.linkgraph.demand_distance = 100;
+	_settings_game.linkgraph.short_path_saturation = 80;
+
+	/* The larger graphs take minutes; run a single size with: openttd_test "[mcf-benchmark]" -c "2000 nodes" */
+	SECTION("500 nodes") { BenchmarkMCF(500); }
+	SECTION("2000 nodes") { BenchmarkMCF(2000); }
+	SECTION("10000 nodes") { BenchmarkMCF(10000); }
+}
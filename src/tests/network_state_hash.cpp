@@ -0,0 +1,84 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file network_state_hash.cpp Test that a client that starts hashing later reports the same hashes as the server. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../clear_map.h"
+#include "../network/network_internal.h"
+#include "../network/network_state_hash.h"
+
+#include "../safeguards.h"
+
+/** First frame the late client hashes. */
+static constexpr uint32_t JOIN_FRAME = 300;
+/** Frame at which a tile is changed while both are hashing. */
+static constexpr uint32_t CHANGE_FRAME = 700;
+/** Last frame that is hashed. */
+static constexpr uint32_t LAST_FRAME = 40 * STATE_HASH_EPOCH_TICKS;
+
+/**
+ * Hash a range of frames.
+ * @param first The first frame.
+ * @param last The last frame.
+ * @param change Whether to change a tile at CHANGE_FRAME.
+ */
+static void HashFrames(uint32_t first, uint32_t last, bool change)
+{
+	for (_frame_counter = first; _frame_counter <= last; _frame_counter++) {
+		if (change && _frame_counter == CHANGE_FRAME) MakeClear(TileXY(20, 30), ClearGround::Rocks, 3);
+		NetworkStateHashTick();
+	}
+}
+
+TEST_CASE("Network state hash")
+{
+	Map::Allocate(64, 64);
+	for (TileIndex tile : Map::Iterate()) {
+		if (IsInnerTile(tile)) MakeClear(tile, ClearGround::Grass, 3);
+	}
+
+	/* The server hashes from the start. Before the client joins, a tile is changed without marking it. */
+	NetworkStateHashReset();
+	HashFrames(1, JOIN_FRAME / 2, false);
+	Tile(TileXY(10, 10)).m5() ^= 0x10;
+	HashFrames(JOIN_FRAME / 2 + 1, LAST_FRAME, true);
+	std::vector<StateHashEpoch> server = NetworkGetStateHashEpochsSince(0);
+
+	/* Undo the change the server saw, so the client sees it happen at the same frame. */
+	MakeClear(TileXY(20, 30), ClearGround::Grass, 3);
+	NetworkStateHashReset();
+	HashFrames(JOIN_FRAME, LAST_FRAME, true);
+	std::vector<StateHashEpoch> client = NetworkGetStateHashEpochsSince(0);
+
+	/* The client only reports once it has hashed everything itself. */
+	REQUIRE(!client.empty());
+	CHECK(client.front().frame >= JOIN_FRAME);
+	for (const StateHashEpoch &epoch : client) {
+		INFO("Epoch " << epoch.frame);
+		auto it = std::ranges::find(server, epoch.frame, &StateHashEpoch::frame);
+		REQUIRE(it != server.end());
+		CHECK(it->hashes == epoch.hashes);
+	}
+
+	/* A change the client does not make is found in the map. */
+	MakeClear(TileXY(20, 30), ClearGround::Grass, 3);
+	NetworkStateHashReset();
+	HashFrames(JOIN_FRAME, LAST_FRAME, false);
+	const StateHashEpoch &last = NetworkGetStateHashEpochsSince(0).back();
+	const StateHashEpoch &server_last = server.back();
+	REQUIRE(last.frame == server_last.frame);
+	CHECK(last.hashes[to_underlying(StateHashSubsystem::Map)] != server_last.hashes[to_underlying(StateHashSubsystem::Map)]);
+	CHECK(last.hashes[to_underlying(StateHashSubsystem::Vehicles)] == server_last.hashes[to_underlying(StateHashSubsystem::Vehicles)]);
+
+	_frame_counter = 0;
+	NetworkStateHashReset();
+}
@@ -50,7 +50,7 @@ static std::tuple<Packet, bool> CreatePacketForReading(Packet &source, MockNetwo
 
 	bool valid = dest.PrepareToRead();
 	dest.Recv_uint8(); // Ignore the type
-	return { dest, valid };
+	return { std::move(dest), valid };
 }
 
 class TestPasswordRequestHandler : public NetworkAuthenticationPasswordRequestHandler {
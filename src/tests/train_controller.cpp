@@ -0,0 +1,147 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file train_controller.cpp Test that the fast path of the train controller moves trains exactly like the full controller. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "mock_environment.h"
+
+#include "../map_func.h"
+#include "../rail_map.h"
+#include "../landscape.h"
+#include "../train.h"
+#include "../vehicle_func.h"
+#include "../settings_type.h"
+
+#include "../safeguards.h"
+
+/** The state of a part of a train after a step. */
+struct TrainPartState {
+	int32_t x_pos; ///< X position.
+	int32_t y_pos; ///< Y position.
+	int32_t z_pos; ///< Z position.
+	TileIndex tile; ///< Tile the part is on.
+	Direction direction; ///< Direction the part faces.
+	TrackBits track; ///< Track the part is on.
+	uint8_t progress; ///< Progress within the current step.
+};
+
+/**
+ * Build the track: a straight line along the X axis, a curve, and a straight line along the Y axis.
+ */
+static void BuildTestTrack()
+{
+	Map::Allocate(64, 64);
+	for (uint x = 4; x < 31; x++) MakeRailNormal(TileXY(x, 10), OWNER_NONE, TRACK_BIT_X, RAILTYPE_RAIL);
+	MakeRailNormal(TileXY(31, 10), OWNER_NONE, TRACK_BIT_RIGHT, RAILTYPE_RAIL);
+	for (uint y = 11; y < 60; y++) MakeRailNormal(TileXY(31, y), OWNER_NONE, TRACK_BIT_Y, RAILTYPE_RAIL);
+}
+
+/**
+ * Build a train on the straight line along the X axis, heading for the curve.
+ * @param parts The number of parts of the train.
+ * @return The front of the train.
+ */
+static Train *BuildTestTrain(uint parts)
+{
+	REQUIRE(Train::CanAllocateItem(parts));
+
+	Train *front = nullptr;
+	Train *prev = nullptr;
+	for (uint i = 0; i < parts; i++) {
+		Train *t = Train::Create();
+		t->owner = OWNER_NONE;
+		t->railtypes = {RAILTYPE_RAIL};
+		t->compatible_railtypes = {RAILTYPE_RAIL};
+		t->gcache.cached_veh_length = VEHICLE_LENGTH;
+		t->direction = DIR_SW;
+		t->track = TRACK_BIT_X;
+		t->x_pos = 20 * TILE_SIZE - i * VEHICLE_LENGTH;
+		t->y_pos = 10 * TILE_SIZE + TILE_SIZE / 2;
+		t->z_pos = GetSlopePixelZ(t->x_pos, t->y_pos, true);
+		t->tile = TileVirtXY(t->x_pos, t->y_pos);
+		if (prev == nullptr) {
+			t->SetFrontEngine();
+			front = t;
+		} else {
+			t->SetWagon();
+			prev->SetNext(t);
+		}
+		t->UpdateDeltaXY();
+		t->UpdatePosition();
+		prev = t;
+	}
+	return front;
+}
+
+/**
+ * Move a train along the test track, and record the state of all its parts after every step.
+ * @param mode How the controller moves the parts of the train.
+ * @param steps The number of steps to move.
+ * @return The states of the parts, for every step.
+ */
+static std::vector<std::vector<TrainPartState>> RunTestTrain(TrainControllerMode mode, uint steps)
+{
+	BuildTestTrack();
+	Train *front = BuildTestTrain(6);
+
+	std::vector<std::vector<TrainPartState>> states;
+	for (uint step = 0; step < steps; step++) {
+		REQUIRE(TrainController(front, nullptr, true, mode));
+		std::vector<TrainPartState> &state = states.emplace_back();
+		for (const Train *t = front; t != nullptr; t = t->Next()) {
+			state.push_back({t->x_pos, t->y_pos, t->z_pos, t->tile, t->direction, t->track, t->progress});
+		}
+	}
+
+	PoolBase::Clean(PoolType::Normal);
+	InitializeVehicles();
+	return states;
+}
+
+TEST_CASE("TrainController fast path")
+{
+	/* The sprites of the train are looked up when it moves. */
+	MockEnvironment::Instance();
+
+	/* No paths are reserved or looked ahead for. */
+	PathfinderSettings pf = _settings_game.pf;
+	_settings_game.pf.reserve_paths = false;
+	_settings_game.pf.path_backoff_interval = 255;
+
+	/* Along the straight line, through the curve and well into the line along the Y axis. */
+	const uint steps = 40 * TILE_SIZE;
+	auto full = RunTestTrain(TrainControllerMode::Full, steps);
+	auto fast = RunTestTrain(TrainControllerMode::Normal, steps);
+
+	REQUIRE(full.size() == fast.size());
+	for (uint step = 0; step < steps; step++) {
+		INFO("Step " << step);
+		REQUIRE(full[step].size() == fast[step].size());
+		for (size_t part = 0; part < full[step].size(); part++) {
+			INFO("Part " << part);
+			const TrainPartState &a = full[step][part];
+			const TrainPartState &b = fast[step][part];
+			CHECK(a.x_pos == b.x_pos);
+			CHECK(a.y_pos == b.y_pos);
+			CHECK(a.z_pos == b.z_pos);
+			CHECK(a.tile == b.tile);
+			CHECK(a.direction == b.direction);
+			CHECK(a.track == b.track);
+			CHECK(a.progress == b.progress);
+		}
+	}
+
+	/* The train went through the curve, so the parts changed direction on the way. */
+	CHECK(fast.back().front().direction == DIR_SE);
+	CHECK(fast.back().back().direction == DIR_SE);
+
+	_settings_game.pf = pf;
+}
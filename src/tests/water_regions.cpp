@@ -0,0 +1,60 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file water_regions.cpp Test that updating the water regions in bulk gives the same regions as updating them on demand. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../water_map.h"
+#include "../pathfinder/water_regions.h"
+
+#include "../safeguards.h"
+
+/**
+ * Get the patch of every tile of the map.
+ * @return The patches, in the order of the tiles.
+ */
+static std::vector<WaterRegionPatchDesc> GetAllPatches()
+{
+	std::vector<WaterRegionPatchDesc> patches;
+	for (TileIndex tile : Map::Iterate()) patches.push_back(GetWaterRegionPatchInfo(tile));
+	return patches;
+}
+
+TEST_CASE("Water regions bulk update")
+{
+	Map::Allocate(128, 128);
+
+	/* Canals in a pattern that splits most regions into several patches. */
+	for (TileIndex tile : Map::Iterate()) {
+		uint x = TileX(tile);
+		uint y = TileY(tile);
+		if (x == 0 || y == 0 || x == Map::MaxX() || y == Map::MaxY()) continue;
+		if (x % 5 == 0 || (y % 7 == 0 && x % 3 != 0) || (x + y) % 11 == 0) MakeCanal(tile, OWNER_NONE, 0);
+	}
+
+	AllocateWaterRegions();
+	const std::vector<WaterRegionPatchDesc> lazy = GetAllPatches();
+	CHECK(GetWaterRegionStatistics().lazy_updates == GetWaterRegionStatistics().regions);
+
+	AllocateWaterRegions();
+	UpdateAllInvalidWaterRegions();
+	WaterRegionStatistics statistics = GetWaterRegionStatistics();
+	CHECK(statistics.invalid_regions == 0);
+	CHECK(statistics.bulk_updates == statistics.regions);
+
+	const std::vector<WaterRegionPatchDesc> bulk = GetAllPatches();
+	CHECK(GetWaterRegionStatistics().lazy_updates == 0);
+	REQUIRE(lazy.size() == bulk.size());
+	for (size_t i = 0; i < lazy.size(); i++) {
+		INFO("Tile " << i);
+		CHECK(lazy[i] == bulk[i]);
+	}
+}
@@ -0,0 +1,162 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <https://www.gnu.org/licenses/old-licenses/gpl-2.0>.
+ */
+
+/** @file yapf_rail_landmarks.cpp Test that the landmark estimate is admissible and reduces the search. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../map_func.h"
+#include "../rail_map.h"
+#include "../pathfinder/pathfinder_type.h"
+#include "../pathfinder/yapf/yapf_rail_landmarks.h"
+#include <queue>
+
+#include "../safeguards.h"
+
+/**
+ * Add tracks to a tile, which becomes a railway tile if it is not one yet.
+ * @param x The X coordinate of the tile.
+ * @param y The Y coordinate of the tile.
+ * @param bits The tracks to add.
+ */
+static void AddTrack(uint x, uint y, TrackBits bits)
+{
+	TileIndex tile = TileXY(x, y);
+	if (IsTileType(tile, TileType::Railway)) {
+		SetTrackBits(tile, GetTrackBits(tile) | bits);
+	} else {
+		MakeRailNormal(tile, OWNER_NONE, bits, RAILTYPE_RAIL);
+	}
+}
+
+/**
+ * Get the rail tiles connected to a tile, the same way the landmarks connect them.
+ * @param tile The tile.
+ * @return The connected tiles.
+ */
+static std::vector<TileIndex> GetConnectedTiles(TileIndex tile)
+{
+	std::vector<TileIndex> result;
+	for (DiagDirection dir = DIAGDIR_BEGIN; dir < DIAGDIR_END; dir++) {
+		TrackBits axis = AxisToTrackBits(DiagDirToAxis(dir));
+		TileIndex next = TileAddByDiagDir(tile, dir);
+		if ((GetTrackBits(tile) & axis) == TRACK_BIT_NONE || !IsValidTile(next) || !IsTileType(next, TileType::Railway)) continue;
+		if ((GetTrackBits(next) & axis) != TRACK_BIT_NONE) result.push_back(next);
+	}
+	return result;
+}
+
+/**
+ * Search for the shortest path over rail between two tiles with A*.
+ * @param from The tile to start at.
+ * @param to The tile to find.
+ * @param estimate The estimate of the cost from a tile to the destination.
+ * @return The cost of the path and the number of expanded tiles.
+ */
+template <typename Testimate>
+static std::pair<int, int> FindPath(TileIndex from, TileIndex to, Testimate estimate)
+{
+	using Item = std::pair<int, TileIndex>; // estimated total cost, tile
+	std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+	std::map<TileIndex, int> costs{{from, 0}};
+	std::set<TileIndex> closed;
+	queue.emplace(estimate(from), from);
+	while (!queue.empty()) {
+		TileIndex tile = queue.top().second;
+		queue.pop();
+		if (!closed.insert(tile).second) continue;
+		if (tile == to) return {costs[tile], static_cast<int>(closed.size())};
+		for (TileIndex next : GetConnectedTiles(tile)) {
+			int cost = costs[tile] + YAPF_TILE_CORNER_LENGTH;
+			auto it = costs.find(next);
+			if (it != costs.end() && it->second <= cost) continue;
+			costs[next] = cost;
+			queue.emplace(cost + estimate(next), next);
+		}
+	}
+	return {-1, static_cast<int>(closed.size())};
+}
+
+/**
+ * Calculate the cost from every rail tile to a tile.
+ * @param to The tile.
+ * @return The cost from each tile that can reach \a to.
+ */
+static std::map<TileIndex, int> CalculateCosts(TileIndex to)
+{
+	std::map<TileIndex, int> costs{{to, 0}};
+	std::queue<TileIndex> queue;
+	queue.push(to);
+	while (!queue.empty()) {
+		TileIndex tile = queue.front();
+		queue.pop();
+		for (TileIndex next : GetConnectedTiles(tile)) {
+			if (costs.emplace(next, costs[tile] + YAPF_TILE_CORNER_LENGTH).second) queue.push(next);
+		}
+	}
+	return costs;
+}
+
+TEST_CASE("YAPF rail landmarks")
+{
+	Map::Allocate(64, 64);
+	YapfRailInvalidateLandmarks(INVALID_TILE);
+
+	/* A horseshoe from (10, 10) to (10, 20), with dead-end spurs from its upper arm pointing at the lower one. */
+	for (uint x = 10; x <= 40; x++) {
+		AddTrack(x, 10, TRACK_BIT_X);
+		AddTrack(x, 20, TRACK_BIT_X);
+	}
+	for (uint y = 10; y <= 20; y++) AddTrack(40, y, TRACK_BIT_Y);
+	for (uint x = 12; x < 40; x += 4) {
+		for (uint y = 10; y <= 18; y++) AddTrack(x, y, TRACK_BIT_Y);
+	}
+
+	TileIndex from = TileXY(10, 10);
+	TileIndex to = TileXY(10, 20);
+	auto check_admissible = [&]() {
+		RailLandmarkTarget target = YapfRailGetLandmarkTarget({&to, 1});
+		REQUIRE(target.IsValid());
+		for (const auto &[tile, cost] : CalculateCosts(to)) {
+			INFO("Tile " << TileX(tile) << "x" << TileY(tile));
+			CHECK(YapfRailGetLandmarkEstimate(tile, target) <= cost);
+		}
+	};
+
+	SECTION("Admissible") {
+		check_admissible();
+	}
+
+	SECTION("Fewer expanded tiles") {
+		RailLandmarkTarget target = YapfRailGetLandmarkTarget({&to, 1});
+		REQUIRE(target.IsValid());
+		auto manhattan = [&](TileIndex tile) { return static_cast<int>(DistanceManhattan(tile, to) * YAPF_TILE_CORNER_LENGTH); };
+		auto landmarks = [&](TileIndex tile) { return std::max(manhattan(tile), YapfRailGetLandmarkEstimate(tile, target)); };
+
+		auto [plain_cost, plain_expanded] = FindPath(from, to, manhattan);
+		auto [landmark_cost, landmark_expanded] = FindPath(from, to, landmarks);
+		CHECK(plain_cost == 70 * YAPF_TILE_CORNER_LENGTH);
+		CHECK(landmark_cost == plain_cost);
+		CHECK(landmark_expanded < plain_expanded);
+	}
+
+	SECTION("Changed layout") {
+		/* Choose the landmarks, then close the gap between a spur and the lower arm. */
+		REQUIRE(YapfRailGetLandmarkTarget({&to, 1}).IsValid());
+		AddTrack(12, 19, TRACK_BIT_Y);
+		AddTrack(12, 20, TRACK_BIT_Y);
+		YapfRailInvalidateLandmarks(TileXY(12, 19));
+		YapfRailInvalidateLandmarks(TileXY(12, 20));
+
+		check_admissible();
+		CHECK(FindPath(from, to, [](TileIndex) { return 0; }).first == 14 * YAPF_TILE_CORNER_LENGTH);
+	}
+
+	YapfRailInvalidateLandmarks(INVALID_TILE);
+}
@@ -14,6 +14,7 @@
 #include "map_func.h"
 #include "core/bitmath_func.hpp"
 #include "settings_type.h"
+#include "network/network_state_hash.h"
 
 /**
  * Returns the height of a tile
@@ -59,6 +60,7 @@ inline void SetTileHeight(Tile tile, uint height)
 	assert(tile < Map::Size());
 	assert(height <= MAX_TILE_HEIGHT);
 	tile.height() = height;
+	StateHashMarkTileChanged(tile);
 }
 
 /**
@@ -136,6 +138,7 @@ inline void SetTileType(Tile tile, TileType type)
 	 * the upper edges of the map are also VOID tiles. */
 	assert(IsInnerTile(tile) == (type != TileType::Void));
 	SB(tile.type(), 4, TILE_TYPE_BITS, to_underlying(type));
+	StateHashMarkTileChanged(tile);
 }
 
 /**
@@ -202,6 +205,7 @@ inline void SetTileOwner(Tile tile, Owner owner)
 	assert(!IsTileType(tile, TileType::Industry));
 
 	SB(tile.m1(), 0, 5, owner.base());
+	StateHashMarkTileChanged(tile);
 }
 
 /**
@@ -59,6 +59,14 @@ static constexpr ConsistChangeFlags CCF_SAVELOAD{ConsistChangeFlag::Length}; ///
 
 uint8_t FreightWagonMult(CargoType cargo);
 
+/** How #TrainController moves the parts of a train. */
+enum class TrainControllerMode : uint8_t {
+	Normal, ///< Move parts that stay within a plain rail tile without the full checks.
+	Full, ///< Do the full checks for every part; the normal mode must move trains exactly the same.
+};
+
+bool TrainController(Train *v, Vehicle *nomove, bool reverse = true, TrainControllerMode mode = TrainControllerMode::Normal);
+
 void CheckTrainsLengths();
 
 void FreeTrainTrackReservation(const Train *v);
@@ -45,7 +45,6 @@
 
 static Track ChooseTrainTrack(Train *v, TileIndex tile, DiagDirection enterdir, TrackBits tracks, bool force_res, bool *got_reservation, bool mark_stuck);
 static bool TrainCheckIfLineEnds(Train *v, bool reverse = true);
-bool TrainController(Train *v, Vehicle *nomove, bool reverse = true); // Also used in vehicle_sl.cpp.
 static TileIndex TrainApproachingCrossingTile(const Train *v);
 static void CheckIfTrainNeedsService(Train *v);
 static void CheckNextTrainTile(Train *v);
@@ -3345,15 +3344,51 @@ static bool CheckTrainCollision(Train *moving_front)
 	return true;
 }
 
+/**
+ * Check whether a part of a train can take the fast path of #TrainController.
+ * That is the case for a part following the moving front, that stays on the
+ * same plain rail tile. Plain rail tiles do nothing when a vehicle moves on
+ * them, and the part cannot change signals, crossings or the path of the
+ * train, so only its position has to be updated.
+ * @param v The part of the train.
+ * @param prev The part in front of \a v, or \c nullptr if \a v is the first part to move.
+ * @param gp The new position of \a v.
+ * @return True iff the part can be moved with #TrainMoveWithinPlainRailTile.
+ */
+static inline bool CanTrainMoveWithinPlainRailTile(const Train *v, const Train *prev, const GetNewVehiclePosResult &gp)
+{
+	return prev != nullptr && !v->IsMovingFront() && gp.old_tile == gp.new_tile && (v->track & TRACK_BIT_MASK) != TRACK_BIT_NONE && IsPlainRailTile(gp.new_tile);
+}
+
+/**
+ * Move a part of a train one step along the plain rail tile it is on.
+ * This does exactly what #TrainController does for such a part.
+ * @param v The part of the train.
+ * @param gp The new position of \a v.
+ */
+static inline void TrainMoveWithinPlainRailTile(Train *v, const GetNewVehiclePosResult &gp)
+{
+	v->UpdateDeltaXY();
+
+	v->x_pos = gp.x;
+	v->y_pos = gp.y;
+	v->UpdatePosition();
+	v->UpdateInclination(false, false);
+}
+
 /**
  * Move a vehicle chain one movement stop forwards.
+ * @tparam Tmode How to move the parts of the train.
  * @param v First vehicle to move.
  * @param nomove Stop moving this and all following vehicles.
  * @param reverse Set to false to not execute the vehicle reversing. This does not change any other logic.
  * @return True if the vehicle could be moved forward, false otherwise.
  */
-bool TrainController(Train *v, Vehicle *nomove, bool reverse)
+template <TrainControllerMode Tmode>
+static bool TrainControllerT(Train *v, Vehicle *nomove, bool reverse)
 {
+	static constexpr bool fast_path = Tmode == TrainControllerMode::Normal;
+
 	Train *first = v->First();
 	Train *prev;
 	bool direction_changed = false; // has direction of any part changed?
@@ -3364,6 +3399,12 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 		bool update_signals_crossing = false; // will we update signals or crossing state?
 
 		GetNewVehiclePosResult gp = GetNewVehiclePos(v);
+		if (fast_path && CanTrainMoveWithinPlainRailTile(v, prev, gp)) {
+			/* Most of the time the wagons of a train just follow the track within their tile. */
+			TrainMoveWithinPlainRailTile(v, gp);
+			continue;
+		}
+
 		if (v->track != TRACK_BIT_WORMHOLE) {
 			/* Not inside tunnel */
 			if (gp.old_tile == gp.new_tile) {
@@ -3378,7 +3419,9 @@ bool TrainController(Train *v, Vehicle *nomove, bool reverse)
 					/* Reverse when we are at the end of the track already, do not move to the new position */
 					if (v->IsMovingFront() && !TrainCheckIfLineEnds(v, reverse)) return false;
 
-					auto vets = VehicleEnterTile(v, gp.new_tile, gp.x, gp.y);
+					/* Plain rail tiles do nothing when a train moves within them. */
+					VehicleEnterTileStates vets{};
+					if (!fast_path || !IsPlainRailTile(gp.new_tile)) vets = VehicleEnterTile(v, gp.new_tile, gp.x, gp.y);
 					if (vets.Test(VehicleEnterTileState::CannotEnter)) {
 						goto invalid_rail;
 					}
@@ -3677,6 +3720,20 @@ reverse_train_direction:
 	return false;
 }
 
+/**
+ * Move a vehicle chain one movement stop forwards.
+ * @param v First vehicle to move.
+ * @param nomove Stop moving this and all following vehicles.
+ * @param reverse Set to false to not execute the vehicle reversing. This does not change any other logic.
+ * @param mode How to move the parts of the train.
+ * @return True if the vehicle could be moved forward, false otherwise.
+ */
+bool TrainController(Train *v, Vehicle *nomove, bool reverse, TrainControllerMode mode)
+{
+	if (mode == TrainControllerMode::Full) return TrainControllerT<TrainControllerMode::Full>(v, nomove, reverse);
+	return TrainControllerT<TrainControllerMode::Normal>(v, nomove, reverse);
+}
+
 static bool IsRailStationPlatformOccupied(TileIndex tile)
 {
 	TileIndexDiff delta = TileOffsByAxis(GetRailStationAxis(tile));
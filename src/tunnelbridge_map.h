@@ -106,6 +106,7 @@ inline void SetTunnelBridgeReservation(Tile t, bool b)
 	assert(IsTileType(t, TileType::TunnelBridge));
 	assert(GetTunnelBridgeTransportType(t) == TRANSPORT_RAIL);
 	AssignBit(t.m5(), 4, b);
+	StateHashMarkTileChanged(t);
 }
 
 /**
@@ -32,6 +32,7 @@
 #include "ai/ai.hpp"
 #include "depot_func.h"
 #include "network/network.h"
+#include "network/network_state_hash.h"
 #include "core/pool_func.hpp"
 #include "economy_base.h"
 #include "articulated_vehicles.h"
@@ -450,6 +451,56 @@ static inline uint GetTileHash(uint x, uint y)
 }
 
 static std::array<Vehicle *, TOTAL_TILE_HASH_SIZE> _vehicle_tile_hash{};
+static std::array<uint64_t, TOTAL_TILE_HASH_SIZE> _road_vehicle_tile_hash_changed{}; ///< Value of #_road_vehicle_tile_hash_changes when a road vehicle in the bucket last changed.
+static uint64_t _road_vehicle_tile_hash_changes = 0; ///< Number of changes of road vehicles in the tile hash.
+
+/**
+ * Get the number of changes of road vehicles in the tile hash so far.
+ * @return The number of changes.
+ */
+uint64_t GetRoadVehicleTileHashChanges()
+{
+	return _road_vehicle_tile_hash_changes;
+}
+
+/**
+ * Mark that the position or state of a road vehicle changed, so searches
+ * for road vehicles near it have to be done again.
+ * @param v The road vehicle that changed.
+ */
+void MarkRoadVehicleTileHashChanged(const Vehicle *v)
+{
+	assert(v->type == VehicleType::Road);
+	if (v->hash_tile_current == nullptr) return;
+	_road_vehicle_tile_hash_changed[v->hash_tile_current - _vehicle_tile_hash.data()] = ++_road_vehicle_tile_hash_changes;
+}
+
+/**
+ * Check whether any road vehicle that VehiclesNearTileXY could find changed since some moment.
+ * @param x The center X-coordinate.
+ * @param y The center Y-coordinate.
+ * @param max_dist The distance around the center to consider.
+ * @param since Result of GetRoadVehicleTileHashChanges() at that moment.
+ * @return \c true iff a road vehicle in the area may have changed.
+ */
+bool HaveRoadVehiclesNearTileXYChanged(int32_t x, int32_t y, uint max_dist, uint64_t since)
+{
+	if (2 * max_dist >= TILE_HASH_MASK * TILE_SIZE) return _road_vehicle_tile_hash_changes != since;
+
+	uint hxmin = GetTileHash1D(std::max<int>(0, x - max_dist) / TILE_SIZE);
+	uint hxmax = GetTileHash1D(std::max<int>(0, x + max_dist) / TILE_SIZE);
+	uint hymin = GetTileHash1D(std::max<int>(0, y - max_dist) / TILE_SIZE);
+	uint hymax = GetTileHash1D(std::max<int>(0, y + max_dist) / TILE_SIZE);
+
+	for (uint hy = hymin;; hy = IncTileHash1D(hy)) {
+		for (uint hx = hxmin;; hx = IncTileHash1D(hx)) {
+			if (_road_vehicle_tile_hash_changed[ComposeTileHash(hx, hy)] > since) return true;
+			if (hx == hxmax) break;
+		}
+		if (hy == hymax) break;
+	}
+	return false;
+}
 
 /**
  * Iterator constructor.
@@ -632,6 +683,12 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 
 	if (old_hash == new_hash) return;
 
+	/* Road vehicles look for road vehicles in the buckets around them. */
+	if (v->type == VehicleType::Road) {
+		if (old_hash != nullptr) _road_vehicle_tile_hash_changed[old_hash - _vehicle_tile_hash.data()] = ++_road_vehicle_tile_hash_changes;
+		if (new_hash != nullptr) _road_vehicle_tile_hash_changed[new_hash - _vehicle_tile_hash.data()] = ++_road_vehicle_tile_hash_changes;
+	}
+
 	/* Remove from the old position in the hash table */
 	if (old_hash != nullptr) {
 		if (v->hash_tile_next != nullptr) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
@@ -827,6 +884,8 @@ void Vehicle::PreDestructor()
 {
 	if (CleaningPool()) return;
 
+	StateHashMarkVehicleChanged(this->index.base());
+
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
 		st->loading_vehicles.remove(this);
@@ -854,6 +913,7 @@ void Vehicle::PreDestructor()
 		if (st != nullptr) {
 			const auto &layout = st->airport.GetFTA()->layout;
 			st->airport.blocks.Reset(layout[a->previous_pos].blocks | layout[a->pos].blocks);
+			WakeAircraftWaitingForBlocks(st);
 		}
 	}
 
@@ -1699,6 +1759,7 @@ void VehicleEnterDepot(Vehicle *v)
 void Vehicle::UpdatePosition()
 {
 	UpdateVehicleTileHash(this, false);
+	StateHashMarkVehicleChanged(this->index.base());
 }
 
 /**
@@ -189,6 +189,10 @@ bool HasVehicleNearTileXY(int32_t x, int32_t y, uint max_dist, UnaryPred &&predi
 	return false;
 }
 
+uint64_t GetRoadVehicleTileHashChanges();
+void MarkRoadVehicleTileHashChanged(const Vehicle *v);
+bool HaveRoadVehiclesNearTileXYChanged(int32_t x, int32_t y, uint max_dist, uint64_t since);
+
 void VehicleServiceInDepot(Vehicle *v);
 uint CountVehiclesInChain(const Vehicle *v);
 void CallVehicleTicks();
@@ -196,6 +200,7 @@ uint8_t CalcPercentVehicleFilled(const Vehicle *v, StringID *colour);
 
 void VehicleLengthChanged(const Vehicle *u);
 
+void InitializeVehicles();
 void ResetVehicleHash();
 void ResetVehicleColourMap();
 
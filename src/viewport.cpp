@@ -87,6 +87,7 @@
 #include "bridge_map.h"
 #include "company_base.h"
 #include "command_func.h"
+#include "network/network.h"
 #include "network/network_func.h"
 #include "framerate_type.h"
 #include "viewport_cmd.h"
@@ -2092,6 +2093,10 @@ static bool MarkViewportDirty(const Viewport &vp, int left, int top, int right,
  */
 bool MarkAllViewportsDirty(int left, int top, int right, int bottom)
 {
+	/* The whole screen is redrawn once the client caught up with the server.
+	 * Until then it is unknown whether the area is visible, so assume it is. */
+	if (_network_catching_up) return true;
+
 	bool dirty = false;
 
 	for (const Window *w : Window::Iterate()) {
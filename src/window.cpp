@@ -3199,6 +3199,9 @@ void UpdateWindows()
  */
 void SetWindowDirty(WindowClass cls, WindowNumber number)
 {
+	/* All windows are redrawn once the client caught up with the server. */
+	if (_network_catching_up) return;
+
 	for (const Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) {
 			w->SetDirty();
@@ -3215,6 +3218,8 @@ void SetWindowDirty(WindowClass cls, WindowNumber number)
  */
 void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, WidgetID widget_index)
 {
+	if (_network_catching_up) return;
+
 	for (const Window *w : Window::Iterate()) {
 		if (w->window_class == cls && w->window_number == number) {
 			w->SetWidgetDirty(widget_index);
@@ -3229,6 +3234,8 @@ void SetWindowWidgetDirty(WindowClass cls, WindowNumber number, WidgetID widget_
  */
 void SetWindowClassesDirty(WindowClass cls)
 {
+	if (_network_catching_up) return;
+
 	for (const Window *w : Window::Iterate()) {
 		if (w->window_class == cls) w->SetDirty();
 	}